@@ -0,0 +1,607 @@
+// This file is for the calendar_benchmarks target
+// it times every conversion and Bahere Hasab path over sequential, random and clustered dates
+// and reports ns/op, throughput and cycles/op as a table or (--json) as JSON for release-to-release tracking
+//
+// usage: calendar_benchmarks [--json] [--filter=SUBSTRING] [--min-time=SECONDS]
+
+#include "batch.h"            // the functions under test
+#include "bahere_hasab.h"
+#include "calendar_cursor.h"
+#include "conversion.h"
+#include "date_search.h"
+#include "display.h"          // for the end-to-end runs
+#include "history_log.h"    // to remove the history the end-to-end runs write
+#include "report_writer.h"  // to drain the reports the end-to-end runs write
+#include "today.h"
+#include "year_grid.h"
+#include <chrono>           // for timing
+#include <cstdio>
+#include <cstdlib>          // for std::atof
+#include <cstring>          // for std::strstr
+#include <ctime>            // for the localtime baselines
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#ifdef _MSC_VER
+#include <intrin.h>         // for __rdtsc
+#else
+#include <x86intrin.h>      // for __rdtsc
+#endif
+#define BENCH_HAVE_TSC 1
+#endif
+
+#ifdef _WIN32
+#include <direct.h>         // for _chdir
+#include <fcntl.h>          // for _O_WRONLY
+#include <io.h>             // for _dup / _dup2
+#else
+#include <fcntl.h>          // for open
+#include <unistd.h>         // for chdir / getcwd / rmdir / dup
+#endif
+
+// Dates per input set; each timed pass walks the whole set once
+const std::size_t BENCH_INPUT_SIZE = 16384;
+
+// Timestamp counter (reference cycles); 0 where there is none
+static unsigned long long readCycles() {
+#ifdef BENCH_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Results are folded into this so the calls cannot be optimized away
+static volatile long benchSink;
+
+// One input set: the same days in every representation the benchmarks need
+struct BenchInput {
+    const char* distribution;
+    std::vector<long> jdn;
+    std::vector<int> gregDay, gregMonth, gregYear;
+    std::vector<int> ethDay, ethMonth, ethYear;
+    std::vector<int> amount;  // days or months to add, -60..60
+};
+
+static BenchInput makeInput(const char* distribution, const std::vector<long>& jdns) {
+    BenchInput input;
+    input.distribution = distribution;
+    input.jdn = jdns;
+    for (long jdn : jdns) {
+        CalendarDate greg = gregorianFromJDN(jdn);
+        CalendarDate eth = ethiopianFromJDN(jdn);
+        input.gregDay.push_back(greg.day);
+        input.gregMonth.push_back(greg.month);
+        input.gregYear.push_back(greg.year);
+        input.ethDay.push_back(eth.day);
+        input.ethMonth.push_back(eth.month);
+        input.ethYear.push_back(eth.year);
+        input.amount.push_back((int)(jdn * 7919 % 121) - 60);
+    }
+    return input;
+}
+
+// Sequential: consecutive days; random: uniform over 1900-2100;
+// clustered: runs of 256 dates within a month of one of 16 random centres
+static std::vector<BenchInput> makeInputs() {
+    const long first = gregorianToJDN(1, 1, 1900);
+    const long last = gregorianToJDN(31, 12, 2100);
+    std::mt19937 random(20240907);
+    std::uniform_int_distribution<long> anyDay(first, last - 31);
+
+    std::vector<long> sequential, uniform, clustered;
+    long centres[16];
+    for (long& centre : centres) centre = anyDay(random);
+    for (std::size_t i = 0; i < BENCH_INPUT_SIZE; i++) {
+        sequential.push_back(gregorianToJDN(1, 1, 2000) + (long)i);
+        uniform.push_back(anyDay(random));
+        clustered.push_back(centres[(i / 256) % 16] + (long)(random() % 31));
+    }
+    return {makeInput("sequential", sequential), makeInput("random", uniform), makeInput("clustered", clustered)};
+}
+
+// Point stdout (and so std::cout) at the null device; returns the saved descriptor, or -1
+static int silenceStdout() {
+    std::fflush(stdout);
+#ifdef _WIN32
+    int saved = _dup(_fileno(stdout));
+    int null = _open("NUL", _O_WRONLY);
+    bool ok = saved >= 0 && null >= 0 && _dup2(null, _fileno(stdout)) == 0;
+    if (null >= 0) _close(null);
+    if (!ok && saved >= 0) _close(saved);
+    if (!ok) return -1;
+#else
+    int saved = dup(fileno(stdout));
+    int null = open("/dev/null", O_WRONLY);
+    bool ok = saved >= 0 && null >= 0 && dup2(null, fileno(stdout)) >= 0;
+    if (null >= 0) close(null);
+    if (!ok && saved >= 0) close(saved);
+    if (!ok) return -1;
+#endif
+    return saved;
+}
+
+static void restoreStdout(int saved) {
+    std::fflush(stdout);
+#ifdef _WIN32
+    _dup2(saved, _fileno(stdout));
+    _close(saved);
+#else
+    dup2(saved, fileno(stdout));
+    close(saved);
+#endif
+}
+
+// Benchmarks: each runs one pass over the input and returns a value derived from the results
+
+static long benchDateToJDNGregorian(const BenchInput& in) {
+    long sum = 0;
+    for (std::size_t i = 0; i < in.jdn.size(); i++) sum += dateToJDN(in.gregDay[i], in.gregMonth[i], in.gregYear[i], true);
+    return sum;
+}
+
+static long benchDateToJDNEthiopian(const BenchInput& in) {
+    long sum = 0;
+    for (std::size_t i = 0; i < in.jdn.size(); i++) sum += dateToJDN(in.ethDay[i], in.ethMonth[i], in.ethYear[i], false);
+    return sum;
+}
+
+static long benchJdnToGreg(const BenchInput& in) {
+    long sum = 0;
+    int d, m, y;
+    for (long jdn : in.jdn) {
+        jdnToGreg(jdn, d, m, y);
+        sum += d + m + y;
+    }
+    return sum;
+}
+
+static long benchJdnToEth(const BenchInput& in) {
+    long sum = 0;
+    int d, m, y;
+    for (long jdn : in.jdn) {
+        jdnToEth(jdn, d, m, y);
+        sum += d + m + y;
+    }
+    return sum;
+}
+
+static long benchJdnToIslamic(const BenchInput& in) {
+    long sum = 0;
+    int d, m, y;
+    for (long jdn : in.jdn) {
+        jdnToIslamic(jdn, d, m, y);
+        sum += d + m + y;
+    }
+    return sum;
+}
+
+// Every calendar of every day, by reconverting each JDN ...
+static long benchConvertJDN(const BenchInput& in) {
+    long sum = 0;
+    ConvertedDate date;
+    for (long jdn = in.jdn[0]; jdn < in.jdn[0] + (long)in.jdn.size(); jdn++) {
+        convertJDN(jdn, date);
+        sum += date.gregorian.day + date.ethiopian.day + date.islamic.day + date.ayyaana;
+    }
+    return sum;
+}
+
+// The JDN -> every calendar paths of calendar_extended.h: the core alone, convertJDN (which checks
+// the window and stays in the core here), the 64-bit arithmetic on the same days, and convertJDN
+// on days a million years back, where it has to take the wide path
+static long sumConverted(const ConvertedDate& date) {
+    return date.gregorian.day + date.ethiopian.day + date.islamic.day + date.ayyaana;
+}
+
+static long benchConvertJDNCore(const BenchInput& in) {
+    long sum = 0;
+    for (long jdn : in.jdn) sum += sumConverted(convertJDNCore(jdn));
+    return sum;
+}
+
+static long benchConvertJDNNarrow(const BenchInput& in) {
+    long sum = 0;
+    ConvertedDate date;
+    for (long jdn : in.jdn) {
+        convertJDN(jdn, date);
+        sum += sumConverted(date);
+    }
+    return sum;
+}
+
+static long benchConvertJDNWide(const BenchInput& in) {
+    long sum = 0;
+    for (long jdn : in.jdn) {
+        sum += WideCalendar<GregorianCalendar>::fromJDN(jdn).day + WideCalendar<EthiopianCalendar>::fromJDN(jdn).day +
+               WideCalendar<IslamicCalendar>::fromJDN(jdn).day + (long)floorMod(jdn, 4);
+    }
+    return sum;
+}
+
+static long benchConvertJDNFar(const BenchInput& in) {
+    const long millionYears = 365242500;
+    long sum = 0;
+    ConvertedDate date;
+    for (long jdn : in.jdn) {
+        convertJDN(jdn - millionYears, date);
+        sum += sumConverted(date);
+    }
+    return sum;
+}
+
+// ... and by walking a cursor over the same days
+static long benchCursorWalk(const BenchInput& in) {
+    long sum = 0;
+    CalendarCursor cursor(in.jdn[0]);
+    for (std::size_t i = 0; i < in.jdn.size(); i++) {
+        ConvertedDate date = cursor.converted();
+        sum += date.gregorian.day + date.ethiopian.day + date.islamic.day + date.ayyaana;
+        cursor.next();
+    }
+    return sum;
+}
+
+static long benchIsValidDate(const BenchInput& in) {
+    long sum = 0;
+    for (std::size_t i = 0; i < in.jdn.size(); i++) {
+        sum += isValidDate(in.gregDay[i], in.gregMonth[i], in.gregYear[i], GREGORIAN);
+        sum += isValidDate(in.ethDay[i], in.ethMonth[i], in.ethYear[i], ETHIOPIAN);
+    }
+    return sum;
+}
+
+// The same checks a column at a time
+static long benchValidateDatesBatch(const BenchInput& in) {
+    std::uint64_t mask[validityMaskWords(BENCH_INPUT_SIZE)];
+    std::size_t count = in.jdn.size();
+    long sum = (long)validateDatesBatch(in.gregDay.data(), in.gregMonth.data(), in.gregYear.data(), count, GREGORIAN, mask);
+    sum += (long)validateDatesBatch(in.ethDay.data(), in.ethMonth.data(), in.ethYear.data(), count, ETHIOPIAN, mask);
+    return sum;
+}
+
+// Date arithmetic on the Ethiopian columns; the batch functions work in place, so each pass copies
+// the columns first
+struct ArithmeticColumns {
+    std::vector<int> day, month, year;
+    explicit ArithmeticColumns(const BenchInput& in) : day(in.ethDay), month(in.ethMonth), year(in.ethYear) {}
+    DateColumns columns() { return {day.data(), month.data(), year.data()}; }
+};
+
+static long benchAddDaysBatch(const BenchInput& in) {
+    std::uint64_t mask[validityMaskWords(BENCH_INPUT_SIZE)];
+    ArithmeticColumns dates(in);
+    return (long)addDaysBatch(dates.columns(), in.amount.data(), in.jdn.size(), ETHIOPIAN, mask) + dates.day[0];
+}
+
+// What callers did before the batch functions: dateToJDN, add, jdnToEth
+static long benchAddDaysRoundTrip(const BenchInput& in) {
+    ArithmeticColumns dates(in);
+    for (std::size_t i = 0; i < in.jdn.size(); i++) {
+        long jdn = dateToJDN(dates.day[i], dates.month[i], dates.year[i], false) + in.amount[i];
+        jdnToEth(jdn, dates.day[i], dates.month[i], dates.year[i]);
+    }
+    return dates.day[0];
+}
+
+static long benchAddMonthsBatch(const BenchInput& in) {
+    std::uint64_t mask[validityMaskWords(BENCH_INPUT_SIZE)];
+    ArithmeticColumns dates(in);
+    return (long)addMonthsBatch(dates.columns(), in.amount.data(), in.jdn.size(), ETHIOPIAN, CLAMP_TO_MONTH_END, mask) +
+           dates.day[0];
+}
+
+// Months from each date to the next input date
+static long benchMonthsBetweenBatch(const BenchInput& in) {
+    std::uint64_t mask[validityMaskWords(BENCH_INPUT_SIZE)];
+    static int months[BENCH_INPUT_SIZE];
+    DateColumns dates = {const_cast<int*>(in.ethDay.data()), const_cast<int*>(in.ethMonth.data()),
+                         const_cast<int*>(in.ethYear.data())};
+    DateColumns next = {dates.day + 1, dates.month + 1, dates.year + 1};
+    return (long)monthsBetweenBatch(dates, next, in.jdn.size() - 1, ETHIOPIAN, months, mask) + months[0];
+}
+
+// Today in every calendar, as the menu and the Bahere Hasab default need it
+static long benchToday(const BenchInput& in) {
+    long sum = 0;
+    for (std::size_t i = 0; i < in.jdn.size(); i++) sum += today().date.ethiopian.year;
+    return sum;
+}
+
+// What they did before today.h: time + localtime + a full conversion per call
+static long benchTodayLocaltime(const BenchInput& in) {
+    long sum = 0;
+    ConvertedDate date;
+    for (std::size_t i = 0; i < in.jdn.size(); i++) {
+        std::time_t now = std::time(nullptr);
+        std::tm* tm = std::localtime(&now);
+        convertJDN(dateToJDN(tm->tm_mday, tm->tm_mon + 1, tm->tm_year + 1900), date);
+        sum += date.ethiopian.year;
+    }
+    return sum;
+}
+
+// A report timestamp per op, a different second each time
+static long benchFormatLocalTimestamp(const BenchInput& in) {
+    char text[LOCAL_TIMESTAMP_BYTES];
+    std::time_t now = std::time(nullptr);
+    long sum = 0;
+    for (std::size_t i = 0; i < in.jdn.size(); i++) {
+        formatLocalTimestamp(now - (std::time_t)(i % 60), text);
+        sum += text[18];
+    }
+    return sum;
+}
+
+static long benchStrftimeTimestamp(const BenchInput& in) {
+    char text[32];
+    std::time_t now = std::time(nullptr);
+    long sum = 0;
+    for (std::size_t i = 0; i < in.jdn.size(); i++) {
+        std::time_t t = now - (std::time_t)(i % 60);
+        std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", std::localtime(&t));
+        sum += text[18];
+    }
+    return sum;
+}
+
+static long benchCalculateBahereHasab(const BenchInput& in) {
+    long sum = 0;
+    BahereHasabResults results;
+    for (int year : in.ethYear) {
+        calculateBahereHasab(year, results);
+        sum += results.metqi;
+    }
+    return sum;
+}
+
+// Years 1-9999 in which Fasika falls on each input's Ethiopian date (mostly none)
+static long benchFindFeastYears(const BenchInput& in) {
+    long sum = 0;
+    for (std::size_t i = 0; i < in.jdn.size(); i++) {
+        sum += (long)findFeastYears(FEAST_FASIKA, ETHIOPIAN, in.ethMonth[i], in.ethDay[i]).count;
+    }
+    return sum;
+}
+
+// The date searches cover 1600-2400 each pass; an op is one day of that range
+const long SEARCH_FIRST_JDN = 2305448;  // 1/1/1600
+const long SEARCH_LAST_JDN = 2598007;   // 31/12/2400
+
+// Sundays that are Dora and the 1st of a Hijri month (one in about 830 days)
+static DateSearchQuery sparseSearchQuery() {
+    DateSearchQuery query;
+    query.weekday = 0;
+    query.ayyaana = 0;
+    query.dates.push_back({ISLAMIC, 0, 1});
+    return query;
+}
+
+static long benchDateSearch(const BenchInput&) {
+    DateSearch search(sparseSearchQuery(), SEARCH_FIRST_JDN, SEARCH_LAST_JDN);
+    long sum = 0, jdn;
+    while (search.next(jdn)) sum += jdn;
+    return sum;
+}
+
+// Two calendar constraints: the sparser drives, the other is checked by conversion
+static long benchDateSearchChecked(const BenchInput&) {
+    DateSearchQuery query;
+    query.dates.push_back({GREGORIAN, 1, 7});
+    query.dates.push_back({ETHIOPIAN, 4, 29});
+    DateSearch search(query, SEARCH_FIRST_JDN, SEARCH_LAST_JDN);
+    long sum = 0, jdn;
+    while (search.next(jdn)) sum += jdn;
+    return sum;
+}
+
+// The sparse query by converting every day, for comparison
+static long benchDateSearchDayByDay(const BenchInput&) {
+    long sum = 0;
+    ConvertedDate date;
+    for (long jdn = SEARCH_FIRST_JDN; jdn <= SEARCH_LAST_JDN; jdn++) {
+        convertJDN(jdn, date);
+        if (weekdayFromJDN(jdn) == 0 && date.ayyaana == 0 && date.islamic.day == 1) sum += jdn;
+    }
+    return sum;
+}
+
+// One whole Ethiopian year per op
+static long benchBuildYearGrid(const BenchInput& in) {
+    long sum = 0;
+    YearGrid grid;
+    for (int year : in.ethYear) {
+        buildYearGrid(year, grid);
+        sum += grid.days[gridIndex(1, 1)].gregorianDay;
+    }
+    return sum;
+}
+
+static long benchDisplayBahereHasab(const BenchInput& in) {
+    BahereHasabResults results;
+    for (int year : in.ethYear) {
+        calculateBahereHasab(year, results);
+        displayBahereHasabResults(results);
+    }
+    return 0;
+}
+
+static long benchConvertAndDisplay(const BenchInput& in) {
+    for (std::size_t i = 0; i < in.jdn.size(); i++) {
+        convertAndDisplayDate(in.gregDay[i], in.gregMonth[i], in.gregYear[i], GREGORIAN);
+    }
+    return 0;
+}
+
+struct Benchmark {
+    const char* name;
+    long (*pass)(const BenchInput&);
+    bool writesOutput;  // prints to stdout and appends to the report / history files
+};
+
+const Benchmark BENCHMARKS[] = {
+    {"dateToJDN/gregorian", benchDateToJDNGregorian, false},
+    {"dateToJDN/ethiopian", benchDateToJDNEthiopian, false},
+    {"jdnToGreg", benchJdnToGreg, false},
+    {"jdnToEth", benchJdnToEth, false},
+    {"jdnToIslamic", benchJdnToIslamic, false},
+    {"convertJDN/day-by-day", benchConvertJDN, false},
+    {"CalendarCursor::next", benchCursorWalk, false},
+    {"convertJDNCore", benchConvertJDNCore, false},
+    {"convertJDN", benchConvertJDNNarrow, false},
+    {"convertJDN/wide-arithmetic", benchConvertJDNWide, false},
+    {"convertJDN/1M-years-back", benchConvertJDNFar, false},
+    {"isValidDate", benchIsValidDate, false},
+    {"validateDatesBatch", benchValidateDatesBatch, false},
+    {"addDaysBatch", benchAddDaysBatch, false},
+    {"addDays/round-trip", benchAddDaysRoundTrip, false},
+    {"addMonthsBatch", benchAddMonthsBatch, false},
+    {"monthsBetweenBatch", benchMonthsBetweenBatch, false},
+    {"today", benchToday, false},
+    {"today/localtime+convert", benchTodayLocaltime, false},
+    {"formatLocalTimestamp", benchFormatLocalTimestamp, false},
+    {"formatLocalTimestamp/strftime", benchStrftimeTimestamp, false},
+    {"calculateBahereHasab", benchCalculateBahereHasab, false},
+    {"findFeastYears", benchFindFeastYears, false},
+    {"DateSearch", benchDateSearch, false},
+    {"DateSearch/checked", benchDateSearchChecked, false},
+    {"DateSearch/day-by-day", benchDateSearchDayByDay, false},
+    {"buildYearGrid", benchBuildYearGrid, false},
+    {"displayBahereHasabResults", benchDisplayBahereHasab, true},
+    {"convertAndDisplayDate", benchConvertAndDisplay, true},
+};
+
+struct BenchResult {
+    std::string name;
+    const char* distribution;
+    unsigned long long ops;
+    double nsPerOp;
+    double cyclesPerOp;  // 0 when the platform has no cycle counter
+};
+
+// Repeat passes until minSeconds have elapsed (after one untimed warm-up pass)
+static BenchResult runBenchmark(const Benchmark& bench, const BenchInput& input, double minSeconds) {
+    typedef std::chrono::steady_clock Clock;
+    long sink = bench.pass(input);
+    std::size_t opsPerPass = input.jdn.size();
+    // One Gregorian and one Ethiopian check per date
+    if (bench.pass == benchIsValidDate || bench.pass == benchValidateDatesBatch) opsPerPass *= 2;
+    if (bench.pass == benchDateSearch || bench.pass == benchDateSearchChecked || bench.pass == benchDateSearchDayByDay) {
+        opsPerPass = SEARCH_LAST_JDN - SEARCH_FIRST_JDN + 1;
+    }
+
+    unsigned long long ops = 0;
+    Clock::time_point start = Clock::now();
+    unsigned long long startCycles = readCycles();
+    double elapsed = 0;
+    do {
+        sink += bench.pass(input);
+        ops += opsPerPass;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed < minSeconds);
+    unsigned long long cycles = readCycles() - startCycles;
+    benchSink = benchSink + sink;
+
+    return {bench.name, input.distribution, ops, elapsed * 1e9 / ops, (double)cycles / ops};
+}
+
+// The end-to-end benchmarks append to report.txt, holidays_report.txt and history.bin;
+// they run inside a scratch directory that is removed afterwards
+static std::string enterScratchDirectory() {
+    char cwd[4096];
+#ifdef _WIN32
+    if (!_getcwd(cwd, sizeof(cwd))) return "";
+    _mkdir("calendar_bench_scratch");
+    if (_chdir("calendar_bench_scratch") != 0) return "";
+#else
+    if (!getcwd(cwd, sizeof(cwd))) return "";
+    char scratch[] = "/tmp/calendar_bench_XXXXXX";
+    if (!mkdtemp(scratch) || chdir(scratch) != 0) return "";
+#endif
+    return cwd;
+}
+
+static void leaveScratchDirectory(const std::string& previous) {
+    stopReportWriter();
+    clearHistory();
+    std::remove("report.txt");
+    std::remove("holidays_report.txt");
+    char scratch[4096];
+#ifdef _WIN32
+    if (!_getcwd(scratch, sizeof(scratch)) || _chdir(previous.c_str()) != 0) return;
+    _rmdir(scratch);
+#else
+    if (!getcwd(scratch, sizeof(scratch)) || chdir(previous.c_str()) != 0) return;
+    rmdir(scratch);
+#endif
+}
+
+static void printTable(const std::vector<BenchResult>& results) {
+    std::printf("%-28s %-11s %12s %14s %12s\n", "benchmark", "dates", "ns/op", "ops/s", "cycles/op");
+    for (const BenchResult& r : results) {
+        std::printf("%-28s %-11s %12.2f %14.0f %12.1f\n", r.name.c_str(), r.distribution, r.nsPerOp,
+                    1e9 / r.nsPerOp, r.cyclesPerOp);
+    }
+#ifndef BENCH_HAVE_TSC
+    std::printf("(no cycle counter on this platform; cycles/op is 0)\n");
+#endif
+}
+
+static void printJson(const std::vector<BenchResult>& results) {
+    std::printf("{\n  \"input_size\": %zu,\n  \"benchmarks\": [\n", BENCH_INPUT_SIZE);
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        std::printf("    {\"name\": \"%s\", \"distribution\": \"%s\", \"ops\": %llu, \"ns_per_op\": %.3f, "
+                    "\"ops_per_second\": %.0f, \"cycles_per_op\": %.2f}%s\n",
+                    r.name.c_str(), r.distribution, r.ops, r.nsPerOp, 1e9 / r.nsPerOp, r.cyclesPerOp,
+                    i + 1 < results.size() ? "," : "");
+    }
+    std::printf("  ]\n}\n");
+}
+
+int main(int argc, char* argv[]) {
+    bool json = false;
+    std::string filter;
+    double minSeconds = 0.2;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--json") json = true;
+        else if (arg.compare(0, 9, "--filter=") == 0) filter = arg.substr(9);
+        else if (arg.compare(0, 11, "--min-time=") == 0) minSeconds = std::atof(arg.c_str() + 11);
+        else {
+            std::fprintf(stderr, "usage: calendar_benchmarks [--json] [--filter=SUBSTRING] [--min-time=SECONDS]\n");
+            return 2;
+        }
+    }
+
+    std::vector<BenchInput> inputs = makeInputs();
+    std::vector<BenchResult> results;
+    for (const Benchmark& bench : BENCHMARKS) {
+        if (!filter.empty() && !std::strstr(bench.name, filter.c_str())) continue;
+
+        std::string previousDirectory;
+        int savedStdout = -1;
+        if (bench.writesOutput) {
+            previousDirectory = enterScratchDirectory();
+            if (!previousDirectory.empty()) savedStdout = silenceStdout();
+            if (savedStdout < 0) {
+                if (!previousDirectory.empty()) leaveScratchDirectory(previousDirectory);
+                std::fprintf(stderr, "calendar_benchmarks: cannot redirect output, skipping %s\n", bench.name);
+                continue;
+            }
+        }
+
+        for (const BenchInput& input : inputs) results.push_back(runBenchmark(bench, input, minSeconds));
+
+        if (bench.writesOutput) {
+            restoreStdout(savedStdout);
+            leaveScratchDirectory(previousDirectory);
+        }
+    }
+
+    if (json) printJson(results);
+    else printTable(results);
+    return 0;
+}
@@ -0,0 +1,139 @@
+// This file is for the calendar_capi_bench target
+// it calls the engine library through its C interface (linked as a shared library, the way an FFI
+// loads it) and reports the time per call and per date for batches of 1 to 1M dates, so the fixed
+// cost of a call can be read off the small batches and the per-date cost off the large ones
+//
+// usage: calendar_capi_bench [--min-time=SECONDS]
+
+#include "calendar_engine.h"  // the interface under test
+#include <stdio.h>
+#include <stdlib.h>  // for malloc / atof
+#include <string.h>  // for strncmp
+#include <time.h>    // for timespec_get
+
+#define MAX_BATCH ((size_t)1 << 20)
+#define MAX_YEAR_BATCH 4096
+
+static const size_t BATCH_SIZES[] = {1, 16, 256, 4096, 65536, MAX_BATCH};
+#define BATCH_SIZE_COUNT (sizeof(BATCH_SIZES) / sizeof(BATCH_SIZES[0]))
+
+// Results are folded into this so the calls cannot be optimized away
+static volatile int64_t sink;
+
+static double now(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Input and output columns, MAX_BATCH rows each
+struct Columns {
+    int64_t* jdn;
+    int32_t *day, *month, *year;       // Gregorian dates of the JDNs
+    int32_t *outDay, *outMonth, *outYear, *ayyaana;
+    int64_t* outJdn;
+    uint64_t* mask;
+};
+
+typedef void (*BenchCall)(struct Columns* c, size_t offset, size_t n);
+
+static void callAbiVersion(struct Columns* c, size_t offset, size_t n) {
+    (void)c, (void)offset, (void)n;
+    sink += cal_abi_version();
+}
+
+static void callFromJdn(struct Columns* c, size_t offset, size_t n) {
+    cal_converted_columns_t out = {{c->outDay + offset, c->outMonth + offset, c->outYear + offset},
+                                   {NULL, NULL, NULL},
+                                   {NULL, NULL, NULL},
+                                   c->ayyaana + offset};
+    cal_from_jdn(c->jdn + offset, n, &out);
+    sink += c->outDay[offset];
+}
+
+static void callToJdn(struct Columns* c, size_t offset, size_t n) {
+    // `offset` is a multiple of 64 for every batch of 64 or more; smaller ones share the first words
+    uint64_t* mask = c->mask + (n >= 64 ? offset / 64 : 0);
+    sink += (int64_t)cal_to_jdn(CAL_GREGORIAN, c->day + offset, c->month + offset, c->year + offset, n,
+                                c->outJdn + offset, mask);
+}
+
+static cal_bahere_hasab_t* bahereOut;
+
+static void callBahereHasab(struct Columns* c, size_t offset, size_t n) {
+    (void)c;
+    sink += (int64_t)cal_bahere_hasab((int32_t)(1 + offset % 4000), n, bahereOut);
+}
+
+// Run `call` over consecutive batches of `batch` rows until `minSeconds` have passed; returns ns per call
+static double timeBatches(BenchCall call, struct Columns* c, size_t batch, double minSeconds) {
+    size_t calls = 0;
+    size_t offset = 0;
+    double start = now(), elapsed;
+    do {
+        for (int i = 0; i < 64; i++) {
+            call(c, offset, batch);
+            offset += batch;
+            if (offset + batch > MAX_BATCH) offset = 0;
+        }
+        calls += 64;
+        elapsed = now() - start;
+    } while (elapsed < minSeconds);
+    return elapsed * 1e9 / (double)calls;
+}
+
+int main(int argc, char* argv[]) {
+    double minSeconds = 0.2;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--min-time=", 11) == 0 && atof(argv[i] + 11) > 0) {
+            minSeconds = atof(argv[i] + 11);
+        } else {
+            fprintf(stderr, "bad argument: %s\nusage: calendar_capi_bench [--min-time=SECONDS]\n", argv[i]);
+            return 2;
+        }
+    }
+    if (cal_abi_version() != CAL_ABI_VERSION) {
+        fprintf(stderr, "calendar_capi_bench: built for ABI %d, library is %d\n", CAL_ABI_VERSION, cal_abi_version());
+        return 1;
+    }
+
+    struct Columns c;
+    c.jdn = malloc(MAX_BATCH * sizeof(int64_t));
+    c.outJdn = malloc(MAX_BATCH * sizeof(int64_t));
+    c.mask = malloc(cal_mask_words(MAX_BATCH) * sizeof(uint64_t));
+    int32_t** intColumns[] = {&c.day, &c.month, &c.year, &c.outDay, &c.outMonth, &c.outYear, &c.ayyaana};
+    for (size_t i = 0; i < sizeof(intColumns) / sizeof(intColumns[0]); i++) {
+        *intColumns[i] = malloc(MAX_BATCH * sizeof(int32_t));
+    }
+    bahereOut = malloc(MAX_YEAR_BATCH * sizeof(cal_bahere_hasab_t));
+
+    // Random days of 1900-2100, and their Gregorian dates through the library itself
+    uint32_t state = 12345;
+    for (size_t i = 0; i < MAX_BATCH; i++) {
+        state = state * 1664525u + 1013904223u;
+        c.jdn[i] = 2415021 + (int64_t)(state % 73049);
+    }
+    cal_converted_columns_t dates = {{c.day, c.month, c.year}, {NULL, NULL, NULL}, {NULL, NULL, NULL}, NULL};
+    cal_from_jdn(c.jdn, MAX_BATCH, &dates);
+
+    struct {
+        const char* name;
+        BenchCall call;
+        size_t maxBatch;
+    } runs[] = {
+        {"cal_abi_version", callAbiVersion, 1},  // the bare cost of a call into the library
+        {"cal_from_jdn", callFromJdn, MAX_BATCH},
+        {"cal_to_jdn", callToJdn, MAX_BATCH},
+        {"cal_bahere_hasab", callBahereHasab, MAX_YEAR_BATCH},  // per Ethiopian year
+    };
+
+    printf("%-18s %10s %14s %12s\n", "call", "batch", "ns/call", "ns/row");
+    for (size_t r = 0; r < sizeof(runs) / sizeof(runs[0]); r++) {
+        for (size_t b = 0; b < BATCH_SIZE_COUNT && BATCH_SIZES[b] <= runs[r].maxBatch; b++) {
+            size_t batch = BATCH_SIZES[b];
+            double ns = timeBatches(runs[r].call, &c, batch, minSeconds);
+            printf("%-18s %10zu %14.1f %12.2f\n", runs[r].name, batch, ns, ns / (double)batch);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,134 @@
+// This file is for the C interface of the calendar engine library
+// it exposes the conversion, arithmetic and Bahere Hasab core to C and to anything with a C FFI
+// (Python ctypes/cffi, Go cgo, ...). Every call works on a whole batch: caller-owned columns plus a
+// count, so the cost of crossing the boundary is paid once per batch, not once per date. Nothing here
+// allocates, throws, reads stdin or writes stdout, and every call is safe from any thread.
+//
+// Columns are day/month/year arrays of int32_t; each pointer must hold at least `count` elements.
+// Calls that can reject a row set bit i % 64 of valid_mask[i / 64] when row i has a result
+// (valid_mask needs cal_mask_words(count) words; bits past `count` are cleared) and return the number
+// of such rows. Rejected rows keep their date and get 0 in output columns. Dates follow the rules of the
+// interactive converter: years 1-5000, and the months and days of the calendar.
+
+#ifndef CALENDAR_ENGINE_H
+#define CALENDAR_ENGINE_H
+
+#include <stddef.h>  // for size_t
+#include <stdint.h>  // for the fixed-width column types
+
+#if defined(_WIN32)
+#  if defined(CALENDAR_ENGINE_BUILD)
+#    define CAL_API __declspec(dllexport)
+#  elif defined(CALENDAR_ENGINE_SHARED)
+#    define CAL_API __declspec(dllimport)
+#  else
+#    define CAL_API
+#  endif
+#elif defined(__GNUC__)
+#  define CAL_API __attribute__((visibility("default")))
+#else
+#  define CAL_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bumped whenever a signature or struct below changes
+#define CAL_ABI_VERSION 1
+
+// Calendars (the values of CalendarType)
+#define CAL_GREGORIAN 1
+#define CAL_ETHIOPIAN 2
+#define CAL_ISLAMIC 3
+#define CAL_JULIAN 4
+#define CAL_COPTIC 5
+
+// What month and year arithmetic does with a day past the end of the resulting month
+#define CAL_REJECT 0         // no result for the row
+#define CAL_CLAMP 1          // 31/1 + 1 month -> 28/2
+#define CAL_ROLL_OVER 2      // 31/1 + 1 month -> 3/3
+
+// Moveable feasts, in the order of cal_bahere_hasab_t.feasts
+#define CAL_FEAST_NINEVEH 0
+#define CAL_FEAST_ABIY_TSOM 1
+#define CAL_FEAST_DEBRE_ZEIT 2
+#define CAL_FEAST_HOSANNA 3
+#define CAL_FEAST_SIKLET 4
+#define CAL_FEAST_FASIKA 5
+#define CAL_FEAST_COUNT 6
+
+// Day/month/year columns of one calendar
+typedef struct cal_columns {
+    int32_t* day;
+    int32_t* month;
+    int32_t* year;
+} cal_columns_t;
+
+// Output of cal_from_jdn; set a member's pointers to NULL to skip that calendar
+typedef struct cal_converted_columns {
+    cal_columns_t gregorian;
+    cal_columns_t ethiopian;
+    cal_columns_t islamic;
+    int32_t* ayyaana;  // 0-3: Dora, Kor, Boka, Shefero
+} cal_converted_columns_t;
+
+typedef struct cal_date {
+    int32_t day;
+    int32_t month;
+    int32_t year;
+} cal_date_t;
+
+// Bahere Hasab for one Ethiopian year
+typedef struct cal_bahere_hasab {
+    int32_t year;
+    int32_t amete_alem;
+    int32_t wenber;
+    int32_t abekte;
+    int32_t metqi;
+    int32_t wengelawi;                   // 0-3: John, Matthew, Mark, Luke
+    cal_date_t feasts[CAL_FEAST_COUNT];  // Ethiopian dates
+} cal_bahere_hasab_t;
+
+// CAL_ABI_VERSION of the library actually loaded
+CAL_API int cal_abi_version(void);
+
+// Words of valid_mask needed for `count` rows
+static inline size_t cal_mask_words(size_t count) { return (count + 63) / 64; }
+
+// Mark the valid dates (an unknown calendar rejects every row)
+CAL_API size_t cal_validate(int calendar, const int32_t* day, const int32_t* month, const int32_t* year,
+                            size_t count, uint64_t* valid_mask);
+
+// Dates of `calendar` -> Julian Day Numbers
+CAL_API size_t cal_to_jdn(int calendar, const int32_t* day, const int32_t* month, const int32_t* year,
+                          size_t count, int64_t* jdn, uint64_t* valid_mask);
+
+// Julian Day Numbers -> Gregorian, Ethiopian, Hijri and Ayyaana columns. Every JDN converts (negative
+// ones and years outside 1-5000 included, for JDNs within about a million years of the present).
+CAL_API void cal_from_jdn(const int64_t* jdn, size_t count, const cal_converted_columns_t* out);
+
+// Arithmetic in one calendar, in place
+CAL_API size_t cal_add_days(int calendar, cal_columns_t dates, const int32_t* days, size_t count,
+                            uint64_t* valid_mask);
+CAL_API size_t cal_add_months(int calendar, cal_columns_t dates, const int32_t* months, size_t count, int overflow,
+                              uint64_t* valid_mask);
+CAL_API size_t cal_add_years(int calendar, cal_columns_t dates, const int32_t* years, size_t count, int overflow,
+                             uint64_t* valid_mask);
+CAL_API size_t cal_end_of_month(int calendar, cal_columns_t dates, size_t count, uint64_t* valid_mask);
+
+// to - from in days, and in whole months (31/1 -> 28/2 is 1 month, 15/3 -> 14/4 is 0)
+CAL_API size_t cal_days_between(int calendar, cal_columns_t from, cal_columns_t to, size_t count, int64_t* days,
+                                uint64_t* valid_mask);
+CAL_API size_t cal_months_between(int calendar, cal_columns_t from, cal_columns_t to, size_t count,
+                                  int32_t* months, uint64_t* valid_mask);
+
+// Bahere Hasab for Ethiopian years first_year .. first_year + count - 1 into out[0 .. count - 1].
+// Returns the number written: 0 unless every year's Amete Alem (year + 5500) is 1 .. INT32_MAX.
+CAL_API size_t cal_bahere_hasab(int32_t first_year, size_t count, cal_bahere_hasab_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CALENDAR_ENGINE_H
@@ -0,0 +1,171 @@
+#include "bahere_hasab.h"  // multi-year Bahere Hasab declarations
+#include "calendar_extended.h"  // Gregorian dates of the early years
+#include <algorithm>  // for std::lower_bound / std::upper_bound
+#include <vector>
+
+// Month/day of each feast for every position in the 532-year cycle, indexed by ameteAlem % 532.
+// Built by the compiler, so lookups never pay for the metqi/tewsak arithmetic at run time.
+// Stored as ready-made MoveableFeasts (year left 0) so a lookup is a copy plus the year fix-up.
+struct FeastCycleTable {
+    MoveableFeasts feasts[PASCHAL_CYCLE_YEARS];
+};
+
+constexpr FeastCycleTable buildFeastCycleTable() {
+    FeastCycleTable table = {};
+    for (int position = 0; position < PASCHAL_CYCLE_YEARS; position++) {
+        // Any year with ameteAlem % 532 == position will do; 5852 = 11 * 532
+        MoveableFeasts feasts = computeMoveableFeasts(position + 5852 - AMETE_ALEM_OFFSET);
+        feasts.year = 0;
+        for (int i = 0; i < FEAST_COUNT; i++) feasts.dates[i].year = 0;
+        table.feasts[position] = feasts;
+    }
+    return table;
+}
+
+static constexpr FeastCycleTable FEAST_CYCLE = buildFeastCycleTable();
+
+// The table only holds if the feast rules really are 532-periodic: for one full cycle of years, every
+// feast's day and month must match the table entry, in that year and 532 * k years before and after
+constexpr bool feastCycleRepeats() {
+    const int shifts[] = {-10 * PASCHAL_CYCLE_YEARS, 0, PASCHAL_CYCLE_YEARS, 7 * PASCHAL_CYCLE_YEARS};
+    for (int year = 1; year <= PASCHAL_CYCLE_YEARS; year++) {
+        const MoveableFeasts& expected = FEAST_CYCLE.feasts[(year + AMETE_ALEM_OFFSET) % PASCHAL_CYCLE_YEARS];
+        for (int shift : shifts) {
+            MoveableFeasts feasts = computeMoveableFeasts(year + shift);
+            for (int i = 0; i < FEAST_COUNT; i++) {
+                if (feasts.dates[i].day != expected.dates[i].day || feasts.dates[i].month != expected.dates[i].month)
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+static_assert(feastCycleRepeats(), "Bahere Hasab feasts repeat every 532 years");
+static_assert(computeBahereHasab(2016).metqi == 10 && computeBahereHasab(2016).wenber == 10, "Bahere Hasab 2016");
+static_assert(computeMoveableFeasts(2016).dates[FEAST_FASIKA].day ==
+                  (computeMoveableFeasts(2016).dates[FEAST_NINEVEH].day + 69 - 1) % 30 + 1,
+              "Fasika is Nineveh + 69 days");
+
+// Copy a cycle entry and stamp it with its year
+static inline void fillFromCycle(int position, int year, MoveableFeasts& out) {
+    out = FEAST_CYCLE.feasts[position];
+    out.year = year;
+    for (int i = 0; i < FEAST_COUNT; i++) out.dates[i].year = year;
+}
+
+MoveableFeasts feastsForYear(int year) {
+    int ameteAlem = year + AMETE_ALEM_OFFSET;
+    if (ameteAlem < 1) return computeMoveableFeasts(year);  // before creation: no cycle position
+
+    MoveableFeasts feasts;
+    fillFromCycle(ameteAlem % PASCHAL_CYCLE_YEARS, year, feasts);
+    return feasts;
+}
+
+std::size_t computeFeastRange(int firstYear, int lastYear, MoveableFeasts* out) {
+    if (lastYear < firstYear) return 0;
+    std::size_t count = (std::size_t)((long)lastYear - firstYear + 1);
+
+    std::size_t i = 0;
+    for (; i < count && firstYear + (int)i + AMETE_ALEM_OFFSET < 1; i++) {
+        out[i] = computeMoveableFeasts(firstYear + (int)i);
+    }
+    // Walk the cycle position alongside the year instead of taking a modulo per year
+    int position = (firstYear + (int)i + AMETE_ALEM_OFFSET) % PASCHAL_CYCLE_YEARS;
+    for (; i < count; i++) {
+        fillFromCycle(position, firstYear + (int)i, out[i]);
+        if (++position == PASCHAL_CYCLE_YEARS) position = 0;
+    }
+    return count;
+}
+
+// Inverted feast index
+
+const int FEAST_INDEX_YEARS = FEAST_INDEX_LAST_YEAR - FEAST_INDEX_FIRST_YEAR + 1;
+// One key per feast, month (1-13) and day (1-31)
+const int FEAST_INDEX_KEYS = FEAST_COUNT * 14 * 32;
+
+constexpr int feastIndexKey(int feast, int month, int day) { return (feast * 14 + month) * 32 + day; }
+
+// Every (feast, year) pair once, grouped by date: the years of key k are
+// years[offsets[k] .. offsets[k + 1]), in ascending order
+struct FeastDateIndex {
+    std::uint32_t offsets[FEAST_INDEX_KEYS + 1];
+    std::uint16_t years[FEAST_COUNT * FEAST_INDEX_YEARS];
+};
+
+struct FeastIndex {
+    FeastDateIndex ethiopian;
+    FeastDateIndex gregorian;
+
+    FeastIndex() {
+        // The Ethiopian dates come straight from the 532-year cycle table
+        std::vector<MoveableFeasts> feasts(FEAST_INDEX_YEARS);
+        computeFeastRange(FEAST_INDEX_FIRST_YEAR, FEAST_INDEX_LAST_YEAR, feasts.data());
+        std::vector<CalendarDate> gregorianDates(feasts.size() * FEAST_COUNT);
+        for (std::size_t y = 0; y < feasts.size(); y++) {
+            for (int i = 0; i < FEAST_COUNT; i++) {
+                const CalendarDate& date = feasts[y].dates[i];
+                long jdn = ethiopianToJDN(date.day, date.month, date.year);
+                gregorianDates[y * FEAST_COUNT + i] = toCalendarDate(extendedFromJDN<GregorianCalendar>(jdn));
+            }
+        }
+        fill(ethiopian, [&](std::size_t y, int i) { return feasts[y].dates[i]; });
+        fill(gregorian, [&](std::size_t y, int i) { return gregorianDates[y * FEAST_COUNT + i]; });
+    }
+
+    // Counting sort by key; walking the years in order leaves every list sorted
+    template <typename DateOf>
+    static void fill(FeastDateIndex& index, DateOf dateOf) {
+        std::fill(index.offsets, index.offsets + FEAST_INDEX_KEYS + 1, 0);
+        for (std::size_t y = 0; y < (std::size_t)FEAST_INDEX_YEARS; y++) {
+            for (int i = 0; i < FEAST_COUNT; i++) {
+                CalendarDate date = dateOf(y, i);
+                index.offsets[feastIndexKey(i, date.month, date.day) + 1]++;
+            }
+        }
+        for (int key = 0; key < FEAST_INDEX_KEYS; key++) index.offsets[key + 1] += index.offsets[key];
+
+        std::vector<std::uint32_t> next(index.offsets, index.offsets + FEAST_INDEX_KEYS);
+        for (std::size_t y = 0; y < (std::size_t)FEAST_INDEX_YEARS; y++) {
+            for (int i = 0; i < FEAST_COUNT; i++) {
+                CalendarDate date = dateOf(y, i);
+                index.years[next[feastIndexKey(i, date.month, date.day)]++] =
+                    (std::uint16_t)(FEAST_INDEX_FIRST_YEAR + (int)y);
+            }
+        }
+    }
+};
+
+static const FeastIndex& feastIndex() {
+    static const FeastIndex index;  // about 260 KB, built in a few milliseconds on first use
+    return index;
+}
+
+FeastYears findFeastYears(MoveableFeast feast, CalendarType calendar, int month, int day, int firstYear, int lastYear) {
+    FeastYears none = {nullptr, 0};
+    if (feast < 0 || feast >= FEAST_COUNT || month < 1 || month > 13 || day < 1 || day > 31) return none;
+    if (calendar != ETHIOPIAN && calendar != GREGORIAN) return none;
+    if (firstYear < FEAST_INDEX_FIRST_YEAR) firstYear = FEAST_INDEX_FIRST_YEAR;
+    if (lastYear > FEAST_INDEX_LAST_YEAR) lastYear = FEAST_INDEX_LAST_YEAR;
+    if (lastYear < firstYear) return none;
+
+    const FeastDateIndex& index = calendar == ETHIOPIAN ? feastIndex().ethiopian : feastIndex().gregorian;
+    int key = feastIndexKey(feast, month, day);
+    const std::uint16_t* begin = index.years + index.offsets[key];
+    const std::uint16_t* end = index.years + index.offsets[key + 1];
+    begin = std::lower_bound(begin, end, (std::uint16_t)firstYear);
+    end = std::upper_bound(begin, end, (std::uint16_t)lastYear);
+    return {begin, (std::size_t)(end - begin)};
+}
+
+bool parseMoveableFeast(const std::string& name, MoveableFeast& feast) {
+    static const char* const NAMES[FEAST_COUNT] = {"nineveh", "abiy-tsom", "debre-zeit", "hosanna", "siklet", "fasika"};
+    for (int i = 0; i < FEAST_COUNT; i++) {
+        if (name == NAMES[i]) {
+            feast = (MoveableFeast)i;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,45 @@
+// This file is for the multi-year Bahere Hasab functions
+// it answers moveable-feast queries for any number of years from a precomputed Paschal-cycle table,
+// without touching std::cout or the report files
+
+#pragma once  // prevent multiple inclusions
+#include "calendar_core.h"
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for the index's year lists
+#include <string>
+
+// The feast calendar repeats every 532 years: the 19-year wenber cycle times the
+// 28-year cycle after which Meskerem 1 falls on the same weekday again
+constexpr int PASCHAL_CYCLE_YEARS = 532;
+
+// Moveable feasts for one Ethiopian year (a table lookup for every year >= -5499)
+MoveableFeasts feastsForYear(int year);
+
+// Fill out[0 .. lastYear - firstYear] with the feasts of firstYear..lastYear.
+// `out` must hold lastYear - firstYear + 1 entries; returns the number written (0 if lastYear < firstYear)
+std::size_t computeFeastRange(int firstYear, int lastYear, MoveableFeasts* out);
+
+// Inverse queries: in which years does a feast fall on a given date?
+// Answered from an index built once (on first use) over years 1-9999: for every feast and
+// Ethiopian or Gregorian month/day, the ascending list of years it falls on that date.
+constexpr int FEAST_INDEX_FIRST_YEAR = 1;
+constexpr int FEAST_INDEX_LAST_YEAR = 9999;
+
+// Ethiopian years, ascending; points into the index, so it stays valid for the life of the program
+struct FeastYears {
+    const std::uint16_t* years;
+    std::size_t count;
+
+    const std::uint16_t* begin() const { return years; }
+    const std::uint16_t* end() const { return years + count; }
+};
+
+// The Ethiopian years in [firstYear, lastYear] (clipped to the index) in which `feast` falls on
+// day/month of `calendar`: ETHIOPIAN, or GREGORIAN, where every moveable feast falls in the Gregorian
+// year after the Ethiopian one began (Ethiopian year + 8). Empty for other calendars and for dates
+// the feast never falls on. Thread-safe.
+FeastYears findFeastYears(MoveableFeast feast, CalendarType calendar, int month, int day,
+                          int firstYear = FEAST_INDEX_FIRST_YEAR, int lastYear = FEAST_INDEX_LAST_YEAR);
+
+// "nineveh", "abiy-tsom", "debre-zeit", "hosanna", "siklet" or "fasika"; returns false for anything else
+bool parseMoveableFeast(const std::string& name, MoveableFeast& feast);
@@ -0,0 +1,577 @@
+#include "batch.h"       // batch conversion declarations
+#include "conversion.h"  // scalar conversion used for out-of-range blocks
+#include <algorithm>     // for std::min
+#include <bitset>        // to count mask bits
+#include <cstring>       // for std::memcpy
+
+// The kernels below work on 32-bit lanes so the compiler can pack 8 (AVX2) or
+// 4 (SSE) dates per instruction. Each kernel is the scalar algorithm from
+// calendar_core.h rewritten without data-dependent branches.
+// On x86-64 Linux GCC builds one clone per instruction set and picks the best
+// at load time; everywhere else the plain auto-vectorized build is used.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+#define BATCH_KERNEL __attribute__((target_clones("avx2", "sse4.2", "default")))
+#else
+#define BATCH_KERNEL
+#endif
+
+// Dates are converted in blocks small enough to stay in L1 between the kernels
+// (a multiple of 64, so validation fills whole mask words)
+static const std::size_t BLOCK_SIZE = 256;
+
+// The kernels are the core's arithmetic, exact inside its window (Hijri epoch to about 132,000 CE,
+// with every intermediate in 32 bits); other blocks take the scalar path, which goes wide
+static const long NARROW_JDN_MIN = (long)NARROW_FIRST_JDN;
+static const long NARROW_JDN_MAX = (long)NARROW_LAST_JDN;
+
+static const int ETHIOPIAN_ERA = (int)ETHIOPIAN_EPOCH_JDN;
+static const int ISLAMIC_EPOCH = (int)ISLAMIC_EPOCH_JDN;
+
+// Copy a block of JDNs into 32-bit lanes; returns false if any falls outside the narrow window
+static bool narrowBlock(const long* jdn, std::size_t count, int* out) {
+    long lo = NARROW_JDN_MIN, hi = NARROW_JDN_MAX;
+    bool inRange = true;
+    for (std::size_t i = 0; i < count; i++) {
+        inRange &= (jdn[i] >= lo) & (jdn[i] <= hi);
+        out[i] = (int)jdn[i];
+    }
+    return inRange;
+}
+
+// Fliegel-Van Flandern, as in gregorianFromJDN
+BATCH_KERNEL
+static void gregKernel(const int* jdn, std::size_t count, int* days, int* months, int* years) {
+    for (std::size_t k = 0; k < count; k++) {
+        int l = jdn[k] + 68569;
+        int n = (4 * l) / 146097;
+        l = l - (146097 * n + 3) / 4;
+        int i = (4000 * (l + 1)) / 1461001;
+        l = l - (1461 * i) / 4 + 31;
+        int j = (80 * l) / 2447;
+        days[k] = l - (2447 * j) / 80;
+        l = j / 11;
+        months[k] = j + 2 - (12 * l);
+        years[k] = 100 * (n - 49) + i + l;
+    }
+}
+
+// 1461-day cycle, as in ethiopianFromJDN
+BATCH_KERNEL
+static void ethKernel(const int* jdn, std::size_t count, int* days, int* months, int* years) {
+    for (std::size_t k = 0; k < count; k++) {
+        int year = (4 * (jdn[k] - ETHIOPIAN_ERA) + 1463) / 1461;
+        int dayOfYear = jdn[k] - ((year - 1) * 365 + year / 4 + ETHIOPIAN_ERA);
+        years[k] = year;
+        months[k] = dayOfYear / 30 + 1;
+        days[k] = dayOfYear % 30 + 1;
+    }
+}
+
+// Tabular Hijri, as in islamicFromJDN, with the same closed-form month lookup
+BATCH_KERNEL
+static void islamicKernel(const int* jdn, std::size_t count, int* days, int* months, int* years) {
+    for (std::size_t k = 0; k < count; k++) {
+        int daysSinceEpoch = jdn[k] - ISLAMIC_EPOCH;
+        int year = (30 * daysSinceEpoch + 10646) / 10631;
+        int yearStart = (year - 1) * 354 + (11 * year + 3) / 30 + ISLAMIC_EPOCH;
+        int dayOfYear = jdn[k] - yearStart;
+
+        int monthIndex = islamicMonthOfDay(dayOfYear);
+        years[k] = year;
+        months[k] = monthIndex + 1;
+        days[k] = dayOfYear - islamicMonthStart(monthIndex) + 1;
+    }
+}
+
+BATCH_KERNEL
+static void ayyaanaKernel(const int* jdn, std::size_t count, int* ayyaana) {
+    for (std::size_t k = 0; k < count; k++) {
+        ayyaana[k] = jdn[k] % 4;
+    }
+}
+
+// Scalar fallback for blocks that leave the narrow window
+static void scalarBlock(const long* jdn, std::size_t count, const BatchConversionOutput& out, std::size_t offset) {
+    for (std::size_t k = 0; k < count; k++) {
+        std::size_t i = offset + k;
+        if (out.gregorian.day) jdnToGreg(jdn[k], out.gregorian.day[i], out.gregorian.month[i], out.gregorian.year[i]);
+        if (out.ethiopian.day) jdnToEth(jdn[k], out.ethiopian.day[i], out.ethiopian.month[i], out.ethiopian.year[i]);
+        if (out.islamic.day) jdnToIslamic(jdn[k], out.islamic.day[i], out.islamic.month[i], out.islamic.year[i]);
+        if (out.ayyaana) out.ayyaana[i] = (int)floorMod(jdn[k], 4);
+    }
+}
+
+void convertJDNBatch(const long* jdn, std::size_t count, const BatchConversionOutput& out) {
+    int lanes[BLOCK_SIZE];
+    for (std::size_t offset = 0; offset < count; offset += BLOCK_SIZE) {
+        std::size_t n = std::min(BLOCK_SIZE, count - offset);
+        if (!narrowBlock(jdn + offset, n, lanes)) {
+            scalarBlock(jdn + offset, n, out, offset);
+            continue;
+        }
+        if (out.gregorian.day)
+            gregKernel(lanes, n, out.gregorian.day + offset, out.gregorian.month + offset, out.gregorian.year + offset);
+        if (out.ethiopian.day)
+            ethKernel(lanes, n, out.ethiopian.day + offset, out.ethiopian.month + offset, out.ethiopian.year + offset);
+        if (out.islamic.day)
+            islamicKernel(lanes, n, out.islamic.day + offset, out.islamic.month + offset, out.islamic.year + offset);
+        if (out.ayyaana)
+            ayyaanaKernel(lanes, n, out.ayyaana + offset);
+    }
+}
+
+void jdnBatchToGreg(const long* jdn, std::size_t count, DateColumns out) {
+    convertJDNBatch(jdn, count, {out, {}, {}, nullptr});
+}
+
+void jdnBatchToEth(const long* jdn, std::size_t count, DateColumns out) {
+    convertJDNBatch(jdn, count, {{}, out, {}, nullptr});
+}
+
+void jdnBatchToIslamic(const long* jdn, std::size_t count, DateColumns out) {
+    convertJDNBatch(jdn, count, {{}, {}, out, nullptr});
+}
+
+// Calendar columns -> JDN; both formulas are branch-free already
+BATCH_KERNEL
+static void gregToJdnKernel(const int* d, const int* m, const int* y, std::size_t count, long* jdnOut) {
+    for (std::size_t k = 0; k < count; k++) {
+        int a = (m[k] - 14) / 12;
+        jdnOut[k] = (1461 * (y[k] + 4800 + a)) / 4 +
+                    (367 * (m[k] - 2 - 12 * a)) / 12 -
+                    (3 * ((y[k] + 4900 + a) / 100)) / 4 + d[k] - 32075;
+    }
+}
+
+BATCH_KERNEL
+static void ethToJdnKernel(const int* d, const int* m, const int* y, std::size_t count, long* jdnOut) {
+    for (std::size_t k = 0; k < count; k++) {
+        jdnOut[k] = (y[k] - 1) * 365 + (y[k] / 4) + (m[k] - 1) * 30 + d[k] + (ETHIOPIAN_ERA - 1);
+    }
+}
+
+void datesToJDNBatch(const int* days, const int* months, const int* years, std::size_t count,
+                     long* jdnOut, bool isGregorian) {
+    if (isGregorian) {
+        gregToJdnKernel(days, months, years, count, jdnOut);
+    } else {
+        ethToJdnKernel(days, months, years, count, jdnOut);
+    }
+}
+
+// Validation
+
+// Month lengths as a flat table [leap year][month] of 16 entries (month 0 and the months past the
+// last are 0, so no day is valid in them); looked up without branches, or gathered by AVX2
+template <typename Calendar>
+struct MonthLengthTable {
+    int days[2 * 16];
+
+    constexpr MonthLengthTable() : days() {
+        for (int leap = 0; leap < 2; leap++) {
+            int year = 1;
+            while (Calendar::isLeapYear(year) != (leap == 1)) year++;
+            for (int month = 1; month <= Calendar::monthsInYear; month++) {
+                days[16 * leap + month] = Calendar::monthLength(month, year);
+            }
+        }
+    }
+};
+
+template <typename Calendar>
+struct MonthLengths {
+    static constexpr MonthLengthTable<Calendar> table = MonthLengthTable<Calendar>();
+};
+template <typename Calendar>
+constexpr MonthLengthTable<Calendar> MonthLengths<Calendar>::table;
+
+static_assert(MonthLengths<EthiopianCalendar>::table.days[16 + 13] == 6 && MonthLengths<EthiopianCalendar>::table.days[13] == 5,
+              "Pagume");
+static_assert(MonthLengths<GregorianCalendar>::table.days[16 + 2] == 29 && MonthLengths<IslamicCalendar>::table.days[12] == 29,
+              "February / Dhu al-Hijjah");
+
+// The longest month of any calendar: larger days are never repaired
+static const int REPAIRABLE_DAY_MAX = 31;
+
+// Gather the low bit of 8 bytes into one byte (byte i -> bit i)
+static inline std::uint64_t packByteFlags(const unsigned char* flags) {
+    std::uint64_t eight;
+    std::memcpy(&eight, flags, 8);
+    return (eight * 0x0102040810204080ULL) >> 56;
+}
+
+// Write the mask words of one block from its per-date flags (which must be zero past `count`, up to a
+// multiple of 64) and return the number of set flags
+static std::size_t packValidMask(const unsigned char* valid, std::size_t count, std::uint64_t* validMask) {
+    std::size_t validCount = 0;
+    for (std::size_t word = 0; word < validityMaskWords(count); word++) {
+        std::uint64_t bits = 0;
+        for (int byte = 0; byte < 8; byte++) bits |= packByteFlags(valid + 64 * word + 8 * byte) << (8 * byte);
+        validMask[word] = bits;
+        validCount += std::bitset<64>(bits).count();
+    }
+    return validCount;
+}
+
+// Validate (and with a repair mode, repair) one block of at most BLOCK_SIZE dates and write its
+// mask words. The results go to local arrays first, which no column can alias, so the main loop
+// is a straight run of compares, gathers from the month table and selects that vectorizes;
+// repaired dates are copied back to the columns afterwards.
+template <typename Calendar, DateRepair Repair>
+BATCH_KERNEL
+static std::size_t validateKernel(const int* d, const int* m, const int* y, std::size_t count, DateColumns out,
+                                  std::uint64_t* validMask) {
+    int lengths[2 * 16];
+    std::memcpy(lengths, MonthLengths<Calendar>::table.days, sizeof(lengths));
+    unsigned char valid[BLOCK_SIZE + 8] = {};
+    int days[BLOCK_SIZE], months[BLOCK_SIZE], years[BLOCK_SIZE];
+
+    for (std::size_t k = 0; k < count; k++) {
+        int day = d[k], month = m[k], year = y[k];
+        bool yearOk = (unsigned)(year - 1) < 5000u;
+        bool monthOk = (unsigned)(month - 1) < (unsigned)Calendar::monthsInYear;
+        int length = lengths[16 * (int)Calendar::isLeapYear(year) + (monthOk ? month : 0)];
+        int ok = (int)yearOk & (int)((unsigned)(day - 1) < (unsigned)length);
+        if (Repair != REJECT_INVALID) {
+            int repair = (int)(yearOk & monthOk) & (int)(day > length) & (int)(day <= REPAIRABLE_DAY_MAX);
+            if (Repair == CLAMP_TO_MONTH_END) {
+                days[k] = day - repair * (day - length);
+                ok |= repair;
+            } else {
+                // The next month always holds the remainder (at most 31 - 5 days)
+                int newYear = repair & (int)(month == Calendar::monthsInYear);
+                days[k] = day - repair * length;
+                months[k] = newYear ? 1 : month + repair;
+                years[k] = year + newYear;
+                ok |= repair & (int)(year + newYear <= 5000);
+            }
+        }
+        valid[k] = (unsigned char)ok;
+    }
+
+    if (Repair != REJECT_INVALID) std::memcpy(out.day, days, count * sizeof(int));
+    if (Repair == ROLL_OVER) {
+        std::memcpy(out.month, months, count * sizeof(int));
+        std::memcpy(out.year, years, count * sizeof(int));
+    }
+
+    return packValidMask(valid, count, validMask);
+}
+
+template <DateRepair Repair>
+static std::size_t validateBlocks(const int* d, const int* m, const int* y, std::size_t count, CalendarType calendar,
+                                  DateColumns out, std::uint64_t* validMask) {
+    std::size_t validCount = 0;
+    for (std::size_t offset = 0; offset < count; offset += BLOCK_SIZE) {
+        std::size_t n = std::min(BLOCK_SIZE, count - offset);
+        DateColumns block = {out.day + offset, out.month + offset, out.year + offset};
+        // BLOCK_SIZE is a multiple of 64, so every block starts on a mask word
+        std::uint64_t* mask = validMask + offset / 64;
+        validCount += visitCalendar(calendar, [&](auto tag) {
+            return validateKernel<decltype(tag), Repair>(d + offset, m + offset, y + offset, n, block, mask);
+        });
+    }
+    return validCount;
+}
+
+std::size_t validateDatesBatch(const int* days, const int* months, const int* years, std::size_t count,
+                               CalendarType calendar, std::uint64_t* validMask) {
+    if (!isKnownCalendar(calendar)) {
+        for (std::size_t word = 0; word < validityMaskWords(count); word++) validMask[word] = 0;
+        return 0;
+    }
+    return validateBlocks<REJECT_INVALID>(days, months, years, count, calendar, {nullptr, nullptr, nullptr}, validMask);
+}
+
+std::size_t normalizeDatesBatch(DateColumns dates, std::size_t count, CalendarType calendar, DateRepair repair,
+                                std::uint64_t* validMask) {
+    if (repair == CLAMP_TO_MONTH_END && isKnownCalendar(calendar)) {
+        return validateBlocks<CLAMP_TO_MONTH_END>(dates.day, dates.month, dates.year, count, calendar, dates, validMask);
+    }
+    if (repair == ROLL_OVER && isKnownCalendar(calendar)) {
+        return validateBlocks<ROLL_OVER>(dates.day, dates.month, dates.year, count, calendar, dates, validMask);
+    }
+    return validateDatesBatch(dates.day, dates.month, dates.year, count, calendar, validMask);
+}
+
+// Arithmetic
+
+// Amounts past these cannot give a valid date from a valid one (5000 years of months or days);
+// capping them there keeps every intermediate in 32 bits
+static const int MAX_MONTH_AMOUNT = 5000 * 13;
+static const int MAX_DAY_AMOUNT = 5000 * 366;
+
+static inline int capAmount(int amount, int limit) { return std::min(std::max(amount, -limit), limit); }
+
+// 1 when a date is valid, as in validateKernel
+template <typename Calendar>
+static inline int isValidLane(int day, int month, int year, const int* lengths) {
+    bool monthOk = (unsigned)(month - 1) < (unsigned)Calendar::monthsInYear;
+    int length = lengths[16 * (int)Calendar::isLeapYear(year) + (monthOk ? month : 0)];
+    return (int)((unsigned)(year - 1) < 5000u) & (int)((unsigned)(day - 1) < (unsigned)length);
+}
+
+// Run f(offset, n) over the blocks of `count` rows and sum what it returns
+template <typename F>
+static std::size_t sumOverBlocks(std::size_t count, F f) {
+    std::size_t total = 0;
+    for (std::size_t offset = 0; offset < count; offset += BLOCK_SIZE) total += f(offset, std::min(BLOCK_SIZE, count - offset));
+    return total;
+}
+
+static std::size_t rejectAll(std::size_t count, std::uint64_t* validMask) {
+    for (std::size_t word = 0; word < validityMaskWords(count); word++) validMask[word] = 0;
+    return 0;
+}
+
+// Months and years: the date as a count of months since 1/1/1 plus a day, so adding is one addition
+// and one division, then the day is checked against the new month. Invalid rows compute on 1/1/1,
+// so nothing overflows, and keep their date.
+template <typename Calendar, DateRepair Overflow>
+BATCH_KERNEL
+static std::size_t addMonthsKernel(const int* d, const int* m, const int* y, const int* amounts, int unit,
+                                   std::size_t count, DateColumns out, std::uint64_t* validMask) {
+    const int monthsInYear = Calendar::monthsInYear;
+    int lengths[2 * 16];
+    std::memcpy(lengths, MonthLengths<Calendar>::table.days, sizeof(lengths));
+    unsigned char valid[BLOCK_SIZE + 8] = {};
+    int days[BLOCK_SIZE], months[BLOCK_SIZE], years[BLOCK_SIZE];
+
+    for (std::size_t k = 0; k < count; k++) {
+        int ok = isValidLane<Calendar>(d[k], m[k], y[k], lengths);
+        int day = ok ? d[k] : 1, month = ok ? m[k] : 1, year = ok ? y[k] : 1;
+        int index = (year - 1) * monthsInYear + month - 1 + capAmount(amounts[k], MAX_MONTH_AMOUNT) * unit;
+        int newYear = index / monthsInYear, newMonth = index % monthsInYear;
+        int borrow = (int)(newMonth < 0);  // index < 0: floor, not truncate
+        newMonth += borrow * monthsInYear + 1;
+        newYear += 1 - borrow;
+
+        ok &= (int)((unsigned)(newYear - 1) < 5000u);
+        int length = lengths[16 * (int)Calendar::isLeapYear(newYear) + newMonth];
+        int over = (int)(day > length);
+        if (Overflow == REJECT_INVALID) ok &= over ^ 1;
+        if (Overflow == CLAMP_TO_MONTH_END) day -= over * (day - length);
+        if (Overflow == ROLL_OVER) {
+            // As in validateKernel, the next month always holds the remainder
+            int nextYear = over & (int)(newMonth == monthsInYear);
+            day -= over * length;
+            newMonth = nextYear ? 1 : newMonth + over;
+            newYear += nextYear;
+            ok &= (int)(newYear <= 5000);
+        }
+        days[k] = ok ? day : d[k];
+        months[k] = ok ? newMonth : m[k];
+        years[k] = ok ? newYear : y[k];
+        valid[k] = (unsigned char)ok;
+    }
+
+    std::memcpy(out.day, days, count * sizeof(int));
+    std::memcpy(out.month, months, count * sizeof(int));
+    std::memcpy(out.year, years, count * sizeof(int));
+    return packValidMask(valid, count, validMask);
+}
+
+template <DateRepair Overflow>
+static std::size_t addMonthsBlocks(DateColumns dates, const int* amounts, std::size_t count, CalendarType calendar,
+                                   bool years, std::uint64_t* validMask) {
+    return visitCalendar(calendar, [&](auto tag) {
+        typedef decltype(tag) Calendar;
+        int unit = years ? Calendar::monthsInYear : 1;
+        return sumOverBlocks(count, [&](std::size_t offset, std::size_t n) {
+            DateColumns block = {dates.day + offset, dates.month + offset, dates.year + offset};
+            return addMonthsKernel<Calendar, Overflow>(block.day, block.month, block.year, amounts + offset, unit, n,
+                                                       block, validMask + offset / 64);
+        });
+    });
+}
+
+static std::size_t addMonthsOrYears(DateColumns dates, const int* amounts, std::size_t count, CalendarType calendar,
+                                    DateRepair overflow, bool years, std::uint64_t* validMask) {
+    if (!isKnownCalendar(calendar)) return rejectAll(count, validMask);
+    if (overflow == CLAMP_TO_MONTH_END) {
+        return addMonthsBlocks<CLAMP_TO_MONTH_END>(dates, amounts, count, calendar, years, validMask);
+    }
+    if (overflow == ROLL_OVER) return addMonthsBlocks<ROLL_OVER>(dates, amounts, count, calendar, years, validMask);
+    return addMonthsBlocks<REJECT_INVALID>(dates, amounts, count, calendar, years, validMask);
+}
+
+std::size_t addMonthsBatch(DateColumns dates, const int* amounts, std::size_t count, CalendarType calendar,
+                           DateRepair overflow, std::uint64_t* validMask) {
+    return addMonthsOrYears(dates, amounts, count, calendar, overflow, false, validMask);
+}
+
+std::size_t addYearsBatch(DateColumns dates, const int* amounts, std::size_t count, CalendarType calendar,
+                          DateRepair overflow, std::uint64_t* validMask) {
+    return addMonthsOrYears(dates, amounts, count, calendar, overflow, true, validMask);
+}
+
+// Days: date -> JDN + amount -> date. The JDN -> date step is the conversion kernel where there is
+// one, and the core per date for Julian and Coptic.
+static void jdnLanesToDates(GregorianCalendar, const int* jdn, std::size_t count, int* d, int* m, int* y) {
+    gregKernel(jdn, count, d, m, y);
+}
+static void jdnLanesToDates(EthiopianCalendar, const int* jdn, std::size_t count, int* d, int* m, int* y) {
+    ethKernel(jdn, count, d, m, y);
+}
+static void jdnLanesToDates(IslamicCalendar, const int* jdn, std::size_t count, int* d, int* m, int* y) {
+    islamicKernel(jdn, count, d, m, y);
+}
+template <typename Calendar>
+static void jdnLanesToDates(Calendar, const int* jdn, std::size_t count, int* d, int* m, int* y) {
+    for (std::size_t k = 0; k < count; k++) {
+        CalendarDate date = Calendar::fromJDN(jdn[k]);
+        d[k] = date.day;
+        m[k] = date.month;
+        y[k] = date.year;
+    }
+}
+
+// Shifted JDNs of one block; a row is valid when its date is and the result stays in years 1-5000
+// (invalid rows get the first valid JDN, which every kernel handles)
+template <typename Calendar>
+BATCH_KERNEL
+static void shiftJdnKernel(const int* d, const int* m, const int* y, const int* amounts, std::size_t count,
+                           int* jdn, unsigned char* valid) {
+    const int first = (int)Calendar::toJDN(1, 1, 1);
+    const int last = (int)Calendar::toJDN(1, 1, 5001) - 1;
+    int lengths[2 * 16];
+    std::memcpy(lengths, MonthLengths<Calendar>::table.days, sizeof(lengths));
+    for (std::size_t k = 0; k < count; k++) {
+        int ok = isValidLane<Calendar>(d[k], m[k], y[k], lengths);
+        int shifted = (int)Calendar::toJDN(ok ? d[k] : 1, ok ? m[k] : 1, ok ? y[k] : 1) +
+                      capAmount(amounts[k], MAX_DAY_AMOUNT);
+        ok &= (int)(shifted >= first) & (int)(shifted <= last);
+        jdn[k] = ok ? shifted : first;
+        valid[k] = (unsigned char)ok;
+    }
+}
+
+std::size_t addDaysBatch(DateColumns dates, const int* amounts, std::size_t count, CalendarType calendar,
+                         std::uint64_t* validMask) {
+    if (!isKnownCalendar(calendar)) return rejectAll(count, validMask);
+    return visitCalendar(calendar, [&](auto tag) {
+        typedef decltype(tag) Calendar;
+        return sumOverBlocks(count, [&](std::size_t offset, std::size_t n) {
+            int jdn[BLOCK_SIZE], days[BLOCK_SIZE], months[BLOCK_SIZE], years[BLOCK_SIZE];
+            unsigned char valid[BLOCK_SIZE + 8] = {};
+            DateColumns block = {dates.day + offset, dates.month + offset, dates.year + offset};
+            shiftJdnKernel<Calendar>(block.day, block.month, block.year, amounts + offset, n, jdn, valid);
+            jdnLanesToDates(tag, jdn, n, days, months, years);
+            for (std::size_t k = 0; k < n; k++) {
+                if (!valid[k]) continue;
+                block.day[k] = days[k];
+                block.month[k] = months[k];
+                block.year[k] = years[k];
+            }
+            return packValidMask(valid, n, validMask + offset / 64);
+        });
+    });
+}
+
+template <typename Calendar>
+BATCH_KERNEL
+static std::size_t endOfMonthKernel(const int* d, const int* m, const int* y, std::size_t count, int* dayOut,
+                                    std::uint64_t* validMask) {
+    int lengths[2 * 16];
+    std::memcpy(lengths, MonthLengths<Calendar>::table.days, sizeof(lengths));
+    unsigned char valid[BLOCK_SIZE + 8] = {};
+    int days[BLOCK_SIZE];
+    for (std::size_t k = 0; k < count; k++) {
+        bool monthOk = (unsigned)(m[k] - 1) < (unsigned)Calendar::monthsInYear;
+        int length = lengths[16 * (int)Calendar::isLeapYear(y[k]) + (monthOk ? m[k] : 0)];
+        int ok = (int)((unsigned)(y[k] - 1) < 5000u) & (int)monthOk;
+        days[k] = d[k] + ok * (length - d[k]);  // a select the vectorizer takes, as in validateKernel
+        valid[k] = (unsigned char)ok;
+    }
+    std::memcpy(dayOut, days, count * sizeof(int));
+    return packValidMask(valid, count, validMask);
+}
+
+std::size_t endOfMonthBatch(DateColumns dates, std::size_t count, CalendarType calendar, std::uint64_t* validMask) {
+    if (!isKnownCalendar(calendar)) return rejectAll(count, validMask);
+    return visitCalendar(calendar, [&](auto tag) {
+        return sumOverBlocks(count, [&](std::size_t offset, std::size_t n) {
+            return endOfMonthKernel<decltype(tag)>(dates.day + offset, dates.month + offset, dates.year + offset, n,
+                                                   dates.day + offset, validMask + offset / 64);
+        });
+    });
+}
+
+template <typename Calendar>
+BATCH_KERNEL
+static std::size_t daysBetweenKernel(DateColumns from, DateColumns to, std::size_t count, long* daysOut,
+                                     std::uint64_t* validMask) {
+    int lengths[2 * 16];
+    std::memcpy(lengths, MonthLengths<Calendar>::table.days, sizeof(lengths));
+    unsigned char valid[BLOCK_SIZE + 8] = {};
+    int days[BLOCK_SIZE];
+    for (std::size_t k = 0; k < count; k++) {
+        int ok = isValidLane<Calendar>(from.day[k], from.month[k], from.year[k], lengths) &
+                 isValidLane<Calendar>(to.day[k], to.month[k], to.year[k], lengths);
+        int fromJdn = (int)Calendar::toJDN(ok ? from.day[k] : 1, ok ? from.month[k] : 1, ok ? from.year[k] : 1);
+        int toJdn = (int)Calendar::toJDN(ok ? to.day[k] : 1, ok ? to.month[k] : 1, ok ? to.year[k] : 1);
+        days[k] = ok ? toJdn - fromJdn : 0;
+        valid[k] = (unsigned char)ok;
+    }
+    for (std::size_t k = 0; k < count; k++) daysOut[k] = days[k];
+    return packValidMask(valid, count, validMask);
+}
+
+std::size_t daysBetweenBatch(DateColumns from, DateColumns to, std::size_t count, CalendarType calendar,
+                             long* days, std::uint64_t* validMask) {
+    if (!isKnownCalendar(calendar)) {
+        for (std::size_t i = 0; i < count; i++) days[i] = 0;
+        return rejectAll(count, validMask);
+    }
+    return visitCalendar(calendar, [&](auto tag) {
+        return sumOverBlocks(count, [&](std::size_t offset, std::size_t n) {
+            DateColumns fromBlock = {from.day + offset, from.month + offset, from.year + offset};
+            DateColumns toBlock = {to.day + offset, to.month + offset, to.year + offset};
+            return daysBetweenKernel<decltype(tag)>(fromBlock, toBlock, n, days + offset, validMask + offset / 64);
+        });
+    });
+}
+
+// Month counts as in addMonthsKernel; from + (toIndex - fromIndex) months lands on the day `anchor` of
+// the month of `to`, and one month less when that passes `to`
+template <typename Calendar>
+BATCH_KERNEL
+static std::size_t monthsBetweenKernel(DateColumns from, DateColumns to, std::size_t count, int* monthsOut,
+                                       std::uint64_t* validMask) {
+    const int monthsInYear = Calendar::monthsInYear;
+    int lengths[2 * 16];
+    std::memcpy(lengths, MonthLengths<Calendar>::table.days, sizeof(lengths));
+    unsigned char valid[BLOCK_SIZE + 8] = {};
+    int months[BLOCK_SIZE];
+    for (std::size_t k = 0; k < count; k++) {
+        int ok = isValidLane<Calendar>(from.day[k], from.month[k], from.year[k], lengths) &
+                 isValidLane<Calendar>(to.day[k], to.month[k], to.year[k], lengths);
+        int fromDay = 1 + ok * (from.day[k] - 1), toDay = 1 + ok * (to.day[k] - 1);
+        int toMonth = 1 + ok * (to.month[k] - 1), toYear = 1 + ok * (to.year[k] - 1);
+        int fromMonth = 1 + ok * (from.month[k] - 1), fromYear = 1 + ok * (from.year[k] - 1);
+        int fromIndex = (fromYear - 1) * monthsInYear + fromMonth - 1;
+        int toIndex = (toYear - 1) * monthsInYear + toMonth - 1;
+        int forward = (int)(toIndex > fromIndex) | ((int)(toIndex == fromIndex) & (int)(toDay >= fromDay));
+        int anchor = std::min(fromDay, lengths[16 * (int)Calendar::isLeapYear(toYear) + toMonth]);
+        int whole = toIndex - fromIndex - (forward & (int)(toDay < anchor)) + ((forward ^ 1) & (int)(toDay > anchor));
+        months[k] = ok * whole;
+        valid[k] = (unsigned char)ok;
+    }
+    std::memcpy(monthsOut, months, count * sizeof(int));
+    return packValidMask(valid, count, validMask);
+}
+
+std::size_t monthsBetweenBatch(DateColumns from, DateColumns to, std::size_t count, CalendarType calendar,
+                               int* months, std::uint64_t* validMask) {
+    if (!isKnownCalendar(calendar)) {
+        for (std::size_t i = 0; i < count; i++) months[i] = 0;
+        return rejectAll(count, validMask);
+    }
+    return visitCalendar(calendar, [&](auto tag) {
+        return sumOverBlocks(count, [&](std::size_t offset, std::size_t n) {
+            DateColumns fromBlock = {from.day + offset, from.month + offset, from.year + offset};
+            DateColumns toBlock = {to.day + offset, to.month + offset, to.year + offset};
+            return monthsBetweenKernel<decltype(tag)>(fromBlock, toBlock, n, months + offset, validMask + offset / 64);
+        });
+    });
+}
@@ -0,0 +1,89 @@
+// This file is for the batch conversion functions
+// it converts whole columns of dates at once instead of one date per call
+
+#pragma once  // prevent multiple inclusions
+#include "data.h"
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for the validity bitmask
+
+// Structure-of-arrays view over caller-owned day/month/year columns.
+// Each pointer must hold at least `count` elements for the call it is passed to.
+struct DateColumns {
+    int* day;
+    int* month;
+    int* year;
+};
+
+// Output columns for convertJDNBatch; set a member to nullptr to skip that calendar
+struct BatchConversionOutput {
+    DateColumns gregorian;
+    DateColumns ethiopian;
+    DateColumns islamic;
+    int* ayyaana;  // index into SIDAMA_AYYAANA
+};
+
+// JDN -> calendar columns (same results as jdnToGreg / jdnToEth / jdnToIslamic)
+void jdnBatchToGreg(const long* jdn, std::size_t count, DateColumns out);
+void jdnBatchToEth(const long* jdn, std::size_t count, DateColumns out);
+void jdnBatchToIslamic(const long* jdn, std::size_t count, DateColumns out);
+
+// Convert a span of JDNs into every requested calendar in one pass
+void convertJDNBatch(const long* jdn, std::size_t count, const BatchConversionOutput& out);
+
+// Calendar columns -> JDN (same results as dateToJDN)
+void datesToJDNBatch(const int* days, const int* months, const int* years, std::size_t count,
+                     long* jdnOut, bool isGregorian = true);
+
+// Validation (the rules of isValidDate: years 1-5000, months and days of the calendar)
+
+// What normalizeDatesBatch does with a day past the end of its month. Only days 1-31 with a
+// valid month and year are repaired; anything else stays invalid.
+enum DateRepair {
+    REJECT_INVALID,      // leave it invalid
+    CLAMP_TO_MONTH_END,  // 29/2/2023 -> 28/2/2023, Pagume 6 2016 -> Pagume 5 2016
+    ROLL_OVER            // 29/2/2023 -> 1/3/2023,  Pagume 6 2016 -> Meskerem 1 2017
+};
+
+// Words of validity mask for `count` dates
+constexpr std::size_t validityMaskWords(std::size_t count) { return (count + 63) / 64; }
+
+// Set bit i % 64 of validMask[i / 64] when date i is valid (validMask needs validityMaskWords(count)
+// words; bits past `count` are cleared). Returns the number of valid dates.
+std::size_t validateDatesBatch(const int* days, const int* months, const int* years, std::size_t count,
+                               CalendarType calendar, std::uint64_t* validMask);
+
+// As validateDatesBatch, but first repairs out-of-range days in place as `repair` says;
+// repaired dates count as valid, so the columns can go straight to datesToJDNBatch
+std::size_t normalizeDatesBatch(DateColumns dates, std::size_t count, CalendarType calendar, DateRepair repair,
+                                std::uint64_t* validMask);
+
+inline bool isValidInMask(const std::uint64_t* validMask, std::size_t i) { return (validMask[i / 64] >> (i % 64)) & 1; }
+
+// Arithmetic, in one calendar at a time over day/month/year columns (the rules of isValidDate for
+// inputs and results alike). Each function sets bit i of validMask (validityMaskWords(count) words)
+// when row i has a result and returns the number of such rows; the other rows keep their date, and
+// get 0 in an output column. Month and year arithmetic works on the month count alone, with no JDN.
+
+// Add amounts[i] days (negative to subtract) to each date, in place
+std::size_t addDaysBatch(DateColumns dates, const int* amounts, std::size_t count, CalendarType calendar,
+                         std::uint64_t* validMask);
+
+// Add amounts[i] calendar months / years to each date, in place. A day past the end of the resulting
+// month is handled as `overflow` says: rejected, clamped (31/1 + 1 month -> 28/2, Pagume 6 + 1 year ->
+// Pagume 5, 30 Dhu al-Hijjah + 1 year -> 29 in a common year) or rolled over into the next month.
+std::size_t addMonthsBatch(DateColumns dates, const int* amounts, std::size_t count, CalendarType calendar,
+                           DateRepair overflow, std::uint64_t* validMask);
+std::size_t addYearsBatch(DateColumns dates, const int* amounts, std::size_t count, CalendarType calendar,
+                          DateRepair overflow, std::uint64_t* validMask);
+
+// Move each date to the last day of its month (only the month and year need to be valid)
+std::size_t endOfMonthBatch(DateColumns dates, std::size_t count, CalendarType calendar, std::uint64_t* validMask);
+
+// to - from, in days
+std::size_t daysBetweenBatch(DateColumns from, DateColumns to, std::size_t count, CalendarType calendar,
+                             long* days, std::uint64_t* validMask);
+
+// to - from in whole months: the n furthest from 0 for which addMonthsBatch with CLAMP_TO_MONTH_END does
+// not pass `to` (31/1 -> 28/2 is 1 month, 15/3 -> 14/4 is 0). Whole years are months / monthsInYear.
+std::size_t monthsBetweenBatch(DateColumns from, DateColumns to, std::size_t count, CalendarType calendar,
+                               int* months, std::uint64_t* validMask);
@@ -0,0 +1,297 @@
+// This file is the compile-time calendar core
+// it holds the pure integer arithmetic behind conversion.cpp as constexpr functions that
+// return value types, so callers can fold constants, build static tables and inline conversions
+
+#pragma once  // prevent multiple inclusions
+#include "data.h"
+
+// Epoch constants
+constexpr long ETHIOPIAN_EPOCH_JDN = 1724221;  // Meskerem 1, 1 ዓ.ም
+constexpr long ISLAMIC_EPOCH_JDN = 1948439;    // 1 Muharram 1 AH (astronomical, Thursday epoch)
+constexpr long COPTIC_EPOCH_JDN = 1825030;     // 1 Thout 1 AM (29 August 284, Julian)
+constexpr int AMETE_ALEM_OFFSET = 5500;        // ዓመተ ዓለም = ዓመተ ምሕረት + 5500
+
+// Leap year rules
+// (bitwise rather than && / ||, which keeps the batch validator's loop free of branches)
+constexpr bool isGregorianLeapYear(int y) { return ((y % 4 == 0) & (y % 100 != 0)) | (y % 400 == 0); }
+// Pagume gets its 6th day in the year before the Evangelist John's year
+constexpr bool isEthiopianLeapYear(int y) { return y % 4 == 3; }
+// Tabular Hijri: 11 leap years per 30-year cycle, the leap day goes to Dhu al-Hijjah
+constexpr bool isIslamicLeapYear(int y) { return (11 * y + 14) % 30 < 11; }
+constexpr bool isJulianLeapYear(int y) { return y % 4 == 0; }
+// The Coptic year is the Ethiopian year - 276, so it shares the Pagume rule
+constexpr bool isCopticLeapYear(int y) { return y % 4 == 3; }
+
+// First day (0-based day of year) of a 0-based Hijri month: months alternate 30/29
+constexpr int islamicMonthStart(int monthIndex) { return 29 * monthIndex + (monthIndex + 1) / 2; }
+// 0-based Hijri month containing a 0-based day of year, in O(1)
+// start(m) <= day  <=>  59m <= 2*day, so m = 2*day/59; day 354 (leap day) stays in month 12
+constexpr int islamicMonthOfDay(int dayOfYear) {
+    int monthIndex = (2 * dayOfYear) / 59;
+    return monthIndex < 11 ? monthIndex : 11;
+}
+
+// Days in a month, per calendar (m must be a month of that calendar)
+constexpr int gregorianMonthLength(int m, int y) {
+    if (m == 2) return isGregorianLeapYear(y) ? 29 : 28;
+    return (m == 4 || m == 6 || m == 9 || m == 11) ? 30 : 31;
+}
+constexpr int julianMonthLength(int m, int y) {
+    if (m == 2) return isJulianLeapYear(y) ? 29 : 28;
+    return gregorianMonthLength(m, y);
+}
+constexpr int ethiopianMonthLength(int m, int y) { return m <= 12 ? 30 : (isEthiopianLeapYear(y) ? 6 : 5); }
+constexpr int copticMonthLength(int m, int y) { return m <= 12 ? 30 : (isCopticLeapYear(y) ? 6 : 5); }
+constexpr int islamicMonthLength(int m, int y) { return 29 + (m % 2) + (m == 12 && isIslamicLeapYear(y)); }
+
+// Calendar date -> JDN
+// Gregorian: Fliegel-Van Flandern; integer division treats months < 3 as months 13/14 of the previous year
+constexpr long gregorianToJDN(int d, int m, int y) {
+    return (1461 * (y + 4800 + (m - 14) / 12)) / 4 +
+           (367 * (m - 2 - 12 * ((m - 14) / 12))) / 12 -
+           (3 * ((y + 4900 + (m - 14) / 12) / 100)) / 4 + d - 32075;
+}
+
+// Ethiopian: 365 days a year plus one every 4th year, 30-day months, from the epoch
+constexpr long ethiopianToJDN(int d, int m, int y) {
+    return (y - 1) * 365L + (y / 4) + (m - 1) * 30 + d + ETHIOPIAN_EPOCH_JDN - 1;
+}
+
+// Islamic: start of the tabular Hijri year plus the 30/29 month starts
+constexpr long islamicToJDN(int d, int m, int y) {
+    return (y - 1) * 354L + (11 * y + 3) / 30 + ISLAMIC_EPOCH_JDN + islamicMonthStart(m - 1) + d - 1;
+}
+
+// Julian: the Gregorian formula without the century correction
+constexpr long julianToJDN(int d, int m, int y) {
+    int a = (14 - m) / 12;
+    long yy = y + 4800L - a;
+    int mm = m + 12 * a - 3;
+    return d + (153 * mm + 2) / 5 + 365 * yy + yy / 4 - 32083;
+}
+
+// Coptic: the Ethiopian rule from its own epoch
+constexpr long copticToJDN(int d, int m, int y) {
+    return (y - 1) * 365L + (y / 4) + (m - 1) * 30 + d + COPTIC_EPOCH_JDN - 1;
+}
+
+// JDN -> calendar date
+constexpr CalendarDate gregorianFromJDN(long jdn) {
+    long l = jdn + 68569;
+    long n = (4 * l) / 146097;
+    l = l - (146097 * n + 3) / 4;
+    long i = (4000 * (l + 1)) / 1461001;
+    l = l - (1461 * i) / 4 + 31;
+    long j = (80 * l) / 2447;
+    int day = (int)(l - (2447 * j) / 80);
+    l = j / 11;
+    int month = (int)(j + 2 - (12 * l));
+    int year = (int)(100 * (n - 49) + i + l);
+    return {day, month, year};
+}
+
+// 1461-day cycle: three 365-day years and one 366-day year (Pagume 6 in years y % 4 == 3),
+// so the year is (4 * days since epoch + 1463) / 1461 and the day of year follows from its start
+constexpr CalendarDate ethiopianFromJDN(long jdn) {
+    int year = (int)((4 * (jdn - ETHIOPIAN_EPOCH_JDN) + 1463) / 1461);
+    int dayOfYear = (int)(jdn - ethiopianToJDN(1, 1, year));
+    return {dayOfYear % 30 + 1, dayOfYear / 30 + 1, year};
+}
+
+// Tabular Islamic calendar (30-year / 10,631-day cycle)
+constexpr CalendarDate islamicFromJDN(long jdn) {
+    long daysSinceEpoch = jdn - ISLAMIC_EPOCH_JDN;
+    int year = (int)((30 * daysSinceEpoch + 10646) / 10631);
+    long yearStart = (year - 1) * 354L + (11 * year + 3) / 30 + ISLAMIC_EPOCH_JDN;
+    int dayOfYear = (int)(jdn - yearStart);
+    int monthIndex = islamicMonthOfDay(dayOfYear);
+    return {dayOfYear - islamicMonthStart(monthIndex) + 1, monthIndex + 1, year};
+}
+
+constexpr CalendarDate julianFromJDN(long jdn) {
+    long c = jdn + 32082;
+    long d = (4 * c + 3) / 1461;
+    long e = c - (1461 * d) / 4;
+    long m = (5 * e + 2) / 153;
+    return {(int)(e - (153 * m + 2) / 5 + 1), (int)(m + 3 - 12 * (m / 10)), (int)(d - 4800 + m / 10)};
+}
+
+constexpr CalendarDate copticFromJDN(long jdn) {
+    int year = (int)((4 * (jdn - COPTIC_EPOCH_JDN) + 1463) / 1461);
+    int dayOfYear = (int)(jdn - copticToJDN(1, 1, year));
+    return {dayOfYear % 30 + 1, dayOfYear / 30 + 1, year};
+}
+
+// Calendar tags
+// Every calendar is a tag type with the same static interface, so generic code (a template over
+// the tag, or a lambda passed to visitCalendar) compiles to direct, inlinable calls.
+// A new calendar is a new tag plus a case in visitCalendar; code that names a tag is unaffected.
+struct GregorianCalendar {
+    static constexpr CalendarType type = GREGORIAN;
+    static constexpr int monthsInYear = 12;
+    static constexpr bool isLeapYear(int y) { return isGregorianLeapYear(y); }
+    static constexpr int monthLength(int m, int y) { return gregorianMonthLength(m, y); }
+    static constexpr long toJDN(int d, int m, int y) { return gregorianToJDN(d, m, y); }
+    static constexpr CalendarDate fromJDN(long jdn) { return gregorianFromJDN(jdn); }
+};
+
+struct EthiopianCalendar {
+    static constexpr CalendarType type = ETHIOPIAN;
+    static constexpr int monthsInYear = 13;  // Pagume is the 13th
+    static constexpr bool isLeapYear(int y) { return isEthiopianLeapYear(y); }
+    static constexpr int monthLength(int m, int y) { return ethiopianMonthLength(m, y); }
+    static constexpr long toJDN(int d, int m, int y) { return ethiopianToJDN(d, m, y); }
+    static constexpr CalendarDate fromJDN(long jdn) { return ethiopianFromJDN(jdn); }
+};
+
+struct IslamicCalendar {
+    static constexpr CalendarType type = ISLAMIC;
+    static constexpr int monthsInYear = 12;
+    static constexpr bool isLeapYear(int y) { return isIslamicLeapYear(y); }
+    static constexpr int monthLength(int m, int y) { return islamicMonthLength(m, y); }
+    static constexpr long toJDN(int d, int m, int y) { return islamicToJDN(d, m, y); }
+    static constexpr CalendarDate fromJDN(long jdn) { return islamicFromJDN(jdn); }
+};
+
+struct JulianCalendar {
+    static constexpr CalendarType type = JULIAN;
+    static constexpr int monthsInYear = 12;
+    static constexpr bool isLeapYear(int y) { return isJulianLeapYear(y); }
+    static constexpr int monthLength(int m, int y) { return julianMonthLength(m, y); }
+    static constexpr long toJDN(int d, int m, int y) { return julianToJDN(d, m, y); }
+    static constexpr CalendarDate fromJDN(long jdn) { return julianFromJDN(jdn); }
+};
+
+struct CopticCalendar {
+    static constexpr CalendarType type = COPTIC;
+    static constexpr int monthsInYear = 13;  // Pi Kogi Enavot is the 13th
+    static constexpr bool isLeapYear(int y) { return isCopticLeapYear(y); }
+    static constexpr int monthLength(int m, int y) { return copticMonthLength(m, y); }
+    static constexpr long toJDN(int d, int m, int y) { return copticToJDN(d, m, y); }
+    static constexpr CalendarDate fromJDN(long jdn) { return copticFromJDN(jdn); }
+};
+
+constexpr bool isKnownCalendar(CalendarType type) { return type >= GREGORIAN && type <= COPTIC; }
+
+// Call f(Tag()) with the tag of `type` (unknown types get the Gregorian tag; check isKnownCalendar first).
+// Inlined, this is one switch around direct calls; f is typically a generic lambda
+template <typename F>
+constexpr auto visitCalendar(CalendarType type, F f) -> decltype(f(GregorianCalendar())) {
+    switch (type) {
+        case ETHIOPIAN: return f(EthiopianCalendar());
+        case ISLAMIC: return f(IslamicCalendar());
+        case JULIAN: return f(JulianCalendar());
+        case COPTIC: return f(CopticCalendar());
+        default: return f(GregorianCalendar());
+    }
+}
+
+// Months in a year of the given calendar
+constexpr int monthsInYear(CalendarType type) {
+    return visitCalendar(type, [](auto calendar) { return decltype(calendar)::monthsInYear; });
+}
+
+// Days in a month of the given calendar (0 for a month that does not exist)
+constexpr int monthLength(int m, int y, CalendarType type) {
+    if (!isKnownCalendar(type)) return 0;
+    return visitCalendar(type, [m, y](auto calendar) {
+        typedef decltype(calendar) Calendar;
+        return (m >= 1 && m <= Calendar::monthsInYear) ? Calendar::monthLength(m, y) : 0;
+    });
+}
+
+// Supported years are 1-5000 in every calendar
+constexpr bool isValidCalendarDate(int d, int m, int y, CalendarType type) {
+    return y >= 1 && y <= 5000 && d >= 1 && d <= monthLength(m, y, type);
+}
+
+// Any calendar <-> JDN
+constexpr long calendarToJDN(CalendarType type, int d, int m, int y) {
+    return visitCalendar(type, [d, m, y](auto calendar) { return decltype(calendar)::toJDN(d, m, y); });
+}
+constexpr CalendarDate calendarFromJDN(CalendarType type, long jdn) {
+    return visitCalendar(type, [jdn](auto calendar) { return decltype(calendar)::fromJDN(jdn); });
+}
+
+// Any calendar -> any calendar; with both tags known at compile time, use To::fromJDN(From::toJDN(...))
+constexpr CalendarDate convertCalendarDate(const CalendarDate& date, CalendarType from, CalendarType to) {
+    return calendarFromJDN(to, calendarToJDN(from, date.day, date.month, date.year));
+}
+
+constexpr int ayyaanaFromJDN(long jdn) { return (int)(jdn % 4); }
+// 0 = Sunday .. 6 = Saturday
+constexpr int weekdayFromJDN(long jdn) { return (int)((jdn + 1) % 7); }
+
+// One JDN in every calendar
+constexpr ConvertedDate convertJDNCore(long jdn) {
+    return {jdn, gregorianFromJDN(jdn), ethiopianFromJDN(jdn), islamicFromJDN(jdn), ayyaanaFromJDN(jdn)};
+}
+
+// Bahere Hasab
+
+// Weekday-specific offset (ተውሳክ) added to metqi
+constexpr int tewsakOffset(int dayIndex) {
+    constexpr int tewsak[] = {3, 2, 1, 0, 5, 4, 3};
+    return tewsak[dayIndex % 7];
+}
+
+// Ecclesiastical numbers for an Ethiopian year; wengelawiIndex selects from WENGELAWI_LIST
+struct BahereHasabValues {
+    int year;
+    int ameteAlem;
+    int wenber;
+    int abekte;
+    int metqi;
+    int wengelawiIndex;
+};
+
+constexpr BahereHasabValues computeBahereHasab(int year) {
+    int ameteAlem = year + AMETE_ALEM_OFFSET;
+    int wenber = (ameteAlem - 1) % 19;
+    int abekte = (wenber * 11) % 30;
+    int metqi = (abekte == 0) ? 30 : (30 - abekte);
+    return {year, ameteAlem, wenber, abekte, metqi, ameteAlem % 4};
+}
+
+// Moveable feasts, in the order they fall
+enum MoveableFeast {
+    FEAST_NINEVEH,     // ጾመ ነነዌ
+    FEAST_ABIY_TSOM,   // ዐቢይ ጾም
+    FEAST_DEBRE_ZEIT,  // ደብረ ዘይት
+    FEAST_HOSANNA,     // ሆሣዕና
+    FEAST_SIKLET,      // ስቅለት
+    FEAST_FASIKA,      // ትንሣኤ (ፋሲካ)
+    FEAST_COUNT
+};
+
+// Days after Nineveh on which each feast falls
+constexpr int FEAST_OFFSETS[FEAST_COUNT] = {0, 14, 41, 62, 67, 69};
+
+// Ethiopian dates of every moveable feast in one year
+struct MoveableFeasts {
+    int year;
+    CalendarDate dates[FEAST_COUNT];
+};
+
+constexpr MoveableFeasts computeMoveableFeasts(const BahereHasabValues& values) {
+    int rabeit = values.ameteAlem / 4;
+    int meskerem1 = (values.ameteAlem + rabeit) % 7;
+    int nMonth = (values.metqi > 14) ? 5 : 6;  // Tir vs Yekatit
+    int dayIdx = (meskerem1 + (nMonth == 5 ? values.metqi - 1 : values.metqi + 29)) % 7;
+    int nDay = values.metqi + tewsakOffset(dayIdx);
+
+    while (nDay > 30) { nDay -= 30; nMonth++; }
+
+    MoveableFeasts feasts = {values.year, {}};
+    for (int i = 0; i < FEAST_COUNT; i++) {
+        int d = nDay + FEAST_OFFSETS[i];
+        int m = nMonth;
+        while (d > 30) { d -= 30; m++; }
+        feasts.dates[i] = {d, m, values.year};
+    }
+    return feasts;
+}
+
+constexpr MoveableFeasts computeMoveableFeasts(int year) {
+    return computeMoveableFeasts(computeBahereHasab(year));
+}
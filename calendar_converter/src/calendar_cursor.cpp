@@ -0,0 +1,106 @@
+#include "calendar_cursor.h"  // cursor declarations
+#include "calendar_extended.h"  // seeks and month lengths outside the core's window
+
+// Hops longer than this reseek instead of carrying month by month
+const long CURSOR_MAX_CARRY_DAYS = 92;
+
+// The core's leap rules take `%` of the year, which goes negative for years <= 0 (Ethiopian and Hijri
+// years before the Hijri epoch); those years take the month length from the wide arithmetic
+static int cursorMonthLength(int month, int year, CalendarType type) {
+    if (year >= 1) return monthLength(month, year, type);
+    return visitCalendar(type, [month, year](auto calendar) {
+        return wideMonthLength<decltype(calendar)>(month, year);
+    });
+}
+
+void CalendarCursor::seek(long jdn) {
+    ConvertedDate converted = convertJDNExtended(jdn);
+    const CalendarDate dates[3] = {converted.gregorian, converted.ethiopian, converted.islamic};
+    jdnValue = jdn;
+    for (int c = 0; c < 3; c++) {
+        MonthSpan& span = months[c];
+        span.start = jdn - (dates[c].day - 1);
+        span.end = span.start + cursorMonthLength(dates[c].month, dates[c].year, (CalendarType)(c + 1));
+        span.month = dates[c].month;
+        span.year = dates[c].year;
+    }
+    updateBounds();
+}
+
+void CalendarCursor::updateBounds() {
+    nextMonthEnd = months[0].end;
+    lastMonthStart = months[0].start;
+    for (int c = 1; c < 3; c++) {
+        if (months[c].end < nextMonthEnd) nextMonthEnd = months[c].end;
+        if (months[c].start > lastMonthStart) lastMonthStart = months[c].start;
+    }
+}
+
+void CalendarCursor::carryForward() {
+    for (int c = 0; c < 3; c++) {
+        MonthSpan& span = months[c];
+        CalendarType type = (CalendarType)(c + 1);
+        while (jdnValue >= span.end) {
+            if (++span.month > monthsInYear(type)) {
+                span.month = 1;
+                span.year++;
+            }
+            span.start = span.end;
+            span.end = span.start + cursorMonthLength(span.month, span.year, type);
+        }
+    }
+    updateBounds();
+}
+
+void CalendarCursor::carryBackward() {
+    for (int c = 0; c < 3; c++) {
+        MonthSpan& span = months[c];
+        CalendarType type = (CalendarType)(c + 1);
+        while (jdnValue < span.start) {
+            if (--span.month < 1) {
+                span.month = monthsInYear(type);
+                span.year--;
+            }
+            span.end = span.start;
+            span.start = span.end - cursorMonthLength(span.month, span.year, type);
+        }
+    }
+    updateBounds();
+}
+
+void CalendarCursor::advance(long days) {
+    if (days > CURSOR_MAX_CARRY_DAYS || days < -CURSOR_MAX_CARRY_DAYS) {
+        seek(jdnValue + days);
+        return;
+    }
+    jdnValue += days;
+    if (jdnValue >= nextMonthEnd) carryForward();
+    else if (jdnValue < lastMonthStart) carryBackward();
+}
+
+void CalendarCursor::advanceMonths(int count, CalendarType calendar) {
+    CalendarDate start = date(calendar);
+    int month = start.month;
+    int year = start.year;
+
+    // From a day of one month to the same day of the next is the length of the first month
+    long days = 0;
+    for (; count > 0; count--) {
+        days += cursorMonthLength(month, year, calendar);
+        if (++month > monthsInYear(calendar)) {
+            month = 1;
+            year++;
+        }
+    }
+    for (; count < 0; count++) {
+        if (--month < 1) {
+            month = monthsInYear(calendar);
+            year--;
+        }
+        days -= cursorMonthLength(month, year, calendar);
+    }
+
+    int targetLength = cursorMonthLength(month, year, calendar);
+    if (start.day > targetLength) days -= start.day - targetLength;
+    advance(days);
+}
@@ -0,0 +1,67 @@
+// This file is for the calendar cursor
+// a CalendarCursor is converted once from a JDN and then keeps the Gregorian, Ethiopian and Islamic
+// months it falls in side by side; moving it is an increment and one compare against the nearest
+// month end, and carries into the next month only when that end is crossed, instead of
+// reconverting every day (for day-by-day tables, schedules and calendar grids)
+
+#pragma once  // prevent multiple inclusions
+#include "calendar_core.h"
+
+class CalendarCursor {
+public:
+    explicit CalendarCursor(long jdn) { seek(jdn); }
+
+    // Reconvert from scratch (the only place the divisions run); exact for any JDN of calendar_extended.h
+    void seek(long jdn);
+
+    // One day forward / back
+    void next() {
+        if (++jdnValue >= nextMonthEnd) carryForward();
+    }
+    void previous() {
+        if (--jdnValue < lastMonthStart) carryBackward();
+    }
+
+    // Any number of days; hops up to a few months are carried, longer ones reseek
+    void advance(long days);
+    void nextWeek() { advance(7); }
+    void previousWeek() { advance(-7); }
+
+    // Whole months in `calendar` (negative to go back), keeping the day of month,
+    // or the last day when the target month is shorter; the other calendars follow.
+    // `calendar` here and in date() is GREGORIAN, ETHIOPIAN or ISLAMIC (the calendars the cursor keeps)
+    void advanceMonths(int months, CalendarType calendar);
+
+    long jdn() const { return jdnValue; }
+    CalendarDate date(CalendarType calendar) const {
+        const MonthSpan& span = months[calendar - 1];
+        return {(int)(jdnValue - span.start) + 1, span.month, span.year};
+    }
+    CalendarDate gregorian() const { return date(GREGORIAN); }
+    CalendarDate ethiopian() const { return date(ETHIOPIAN); }
+    CalendarDate islamic() const { return date(ISLAMIC); }
+    int ayyaana() const { return ayyaanaFromJDN(jdnValue); }  // index into SIDAMA_AYYAANA
+    int weekday() const { return weekdayFromJDN(jdnValue); }  // 0 = Sunday
+    ConvertedDate converted() const { return {jdnValue, gregorian(), ethiopian(), islamic(), ayyaana()}; }
+
+private:
+    // The month a calendar is in: JDNs start .. end - 1
+    struct MonthSpan {
+        long start;
+        long end;
+        int month;
+        int year;
+    };
+
+    // Move every calendar whose month the cursor has left into the next / previous month
+    // (Pagume 5/6 and the Hijri leap day come from the month lengths); out of line because it
+    // runs about three times a month
+    void carryForward();
+    void carryBackward();
+    void updateBounds();
+
+    long jdnValue;
+    MonthSpan months[3];   // indexed by CalendarType - 1
+    long nextMonthEnd;     // earliest months[c].end
+    long lastMonthStart;   // latest months[c].start
+};
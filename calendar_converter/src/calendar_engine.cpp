@@ -0,0 +1,154 @@
+#include "calendar_engine.h"  // C interface declarations
+#include "batch.h"            // the column kernels behind every call
+#include "bahere_hasab.h"     // feastsForYear / computeFeastRange
+#include <algorithm>          // for std::min
+#include <climits>            // for INT_MAX
+#include <type_traits>        // for std::is_same
+
+// The C columns are handed to the C++ kernels as they are
+static_assert(std::is_same<std::int32_t, int>::value, "the C ABI assumes a 32-bit int");
+static_assert(CAL_GREGORIAN == GREGORIAN && CAL_ETHIOPIAN == ETHIOPIAN && CAL_ISLAMIC == ISLAMIC &&
+                  CAL_JULIAN == JULIAN && CAL_COPTIC == COPTIC,
+              "CAL_* calendars must match CalendarType");
+static_assert(CAL_REJECT == REJECT_INVALID && CAL_CLAMP == CLAMP_TO_MONTH_END && CAL_ROLL_OVER == ROLL_OVER,
+              "CAL_* overflow modes must match DateRepair");
+static_assert(CAL_FEAST_COUNT == FEAST_COUNT && CAL_FEAST_FASIKA == FEAST_FASIKA, "CAL_FEAST_* must match MoveableFeast");
+
+// JDNs are int64_t at the boundary and `long` inside, which is narrower on Windows; calls that need a
+// `long` buffer there go through one of these, a multiple of 64 rows so each chunk has whole mask words
+static const std::size_t CHUNK_SIZE = 256;
+static const bool LONG_IS_INT64 = std::is_same<long, std::int64_t>::value;
+
+static DateColumns toColumns(cal_columns_t columns) { return {columns.day, columns.month, columns.year}; }
+
+static DateColumns offsetColumns(DateColumns columns, std::size_t offset) {
+    return {columns.day + offset, columns.month + offset, columns.year + offset};
+}
+
+static CalendarType toCalendar(int calendar) { return (CalendarType)calendar; }
+
+// Unknown modes reject, like the unrepairable dates of the other two
+static DateRepair toRepair(int overflow) {
+    return overflow == CAL_CLAMP || overflow == CAL_ROLL_OVER ? (DateRepair)overflow : REJECT_INVALID;
+}
+
+extern "C" {
+
+int cal_abi_version(void) { return CAL_ABI_VERSION; }
+
+size_t cal_validate(int calendar, const int32_t* day, const int32_t* month, const int32_t* year, size_t count,
+                    uint64_t* valid_mask) {
+    return validateDatesBatch(day, month, year, count, toCalendar(calendar), valid_mask);
+}
+
+size_t cal_to_jdn(int calendar, const int32_t* day, const int32_t* month, const int32_t* year, size_t count,
+                  int64_t* jdn, uint64_t* valid_mask) {
+    std::size_t valid = validateDatesBatch(day, month, year, count, toCalendar(calendar), valid_mask);
+    bool kernel = calendar == CAL_GREGORIAN || calendar == CAL_ETHIOPIAN;  // the rest have no batch kernel
+    long chunk[CHUNK_SIZE];
+    for (std::size_t offset = 0; offset < count; offset += CHUNK_SIZE) {
+        std::size_t n = std::min(CHUNK_SIZE, count - offset);
+        if (kernel) {
+            datesToJDNBatch(day + offset, month + offset, year + offset, n, chunk, calendar == CAL_GREGORIAN);
+        }
+        for (std::size_t k = 0; k < n; k++) {
+            std::size_t i = offset + k;
+            if (!isValidInMask(valid_mask, i)) {
+                jdn[i] = 0;
+            } else {
+                jdn[i] = kernel ? chunk[k] : calendarToJDN(toCalendar(calendar), day[i], month[i], year[i]);
+            }
+        }
+    }
+    return valid;
+}
+
+void cal_from_jdn(const int64_t* jdn, size_t count, const cal_converted_columns_t* out) {
+    BatchConversionOutput columns = {toColumns(out->gregorian), toColumns(out->ethiopian), toColumns(out->islamic),
+                                     out->ayyaana};
+    if constexpr (LONG_IS_INT64) {
+        convertJDNBatch(reinterpret_cast<const long*>(jdn), count, columns);
+        return;
+    }
+    long chunk[CHUNK_SIZE];
+    for (std::size_t offset = 0; offset < count; offset += CHUNK_SIZE) {
+        std::size_t n = std::min(CHUNK_SIZE, count - offset);
+        for (std::size_t k = 0; k < n; k++) chunk[k] = (long)jdn[offset + k];  // the extended range fits
+        BatchConversionOutput part = columns;
+        for (DateColumns* calendar : {&part.gregorian, &part.ethiopian, &part.islamic}) {
+            if (calendar->day) *calendar = offsetColumns(*calendar, offset);
+        }
+        if (part.ayyaana) part.ayyaana += offset;
+        convertJDNBatch(chunk, n, part);
+    }
+}
+
+size_t cal_add_days(int calendar, cal_columns_t dates, const int32_t* days, size_t count, uint64_t* valid_mask) {
+    return addDaysBatch(toColumns(dates), days, count, toCalendar(calendar), valid_mask);
+}
+
+size_t cal_add_months(int calendar, cal_columns_t dates, const int32_t* months, size_t count, int overflow,
+                      uint64_t* valid_mask) {
+    return addMonthsBatch(toColumns(dates), months, count, toCalendar(calendar), toRepair(overflow), valid_mask);
+}
+
+size_t cal_add_years(int calendar, cal_columns_t dates, const int32_t* years, size_t count, int overflow,
+                     uint64_t* valid_mask) {
+    return addYearsBatch(toColumns(dates), years, count, toCalendar(calendar), toRepair(overflow), valid_mask);
+}
+
+size_t cal_end_of_month(int calendar, cal_columns_t dates, size_t count, uint64_t* valid_mask) {
+    return endOfMonthBatch(toColumns(dates), count, toCalendar(calendar), valid_mask);
+}
+
+size_t cal_days_between(int calendar, cal_columns_t from, cal_columns_t to, size_t count, int64_t* days,
+                        uint64_t* valid_mask) {
+    if constexpr (LONG_IS_INT64) {
+        return daysBetweenBatch(toColumns(from), toColumns(to), count, toCalendar(calendar),
+                                reinterpret_cast<long*>(days), valid_mask);
+    }
+    std::size_t valid = 0;
+    long chunk[CHUNK_SIZE];
+    for (std::size_t offset = 0; offset < count; offset += CHUNK_SIZE) {
+        std::size_t n = std::min(CHUNK_SIZE, count - offset);
+        valid += daysBetweenBatch(offsetColumns(toColumns(from), offset), offsetColumns(toColumns(to), offset), n,
+                                  toCalendar(calendar), chunk, valid_mask + offset / 64);
+        for (std::size_t k = 0; k < n; k++) days[offset + k] = chunk[k];
+    }
+    return valid;
+}
+
+size_t cal_months_between(int calendar, cal_columns_t from, cal_columns_t to, size_t count, int32_t* months,
+                          uint64_t* valid_mask) {
+    return monthsBetweenBatch(toColumns(from), toColumns(to), count, toCalendar(calendar), months, valid_mask);
+}
+
+size_t cal_bahere_hasab(int32_t first_year, size_t count, cal_bahere_hasab_t* out) {
+    const int lastAllowed = INT_MAX - AMETE_ALEM_OFFSET;
+    if (count == 0 || first_year < 1 - AMETE_ALEM_OFFSET || first_year > lastAllowed) return 0;
+    if (count - 1 > (std::size_t)((long long)lastAllowed - first_year)) return 0;
+
+    MoveableFeasts feasts[CHUNK_SIZE];
+    for (std::size_t offset = 0; offset < count; offset += CHUNK_SIZE) {
+        std::size_t n = std::min(CHUNK_SIZE, count - offset);
+        int year = first_year + (int)offset;
+        computeFeastRange(year, year + (int)n - 1, feasts);
+        for (std::size_t k = 0; k < n; k++) {
+            BahereHasabValues values = computeBahereHasab(year + (int)k);
+            cal_bahere_hasab_t& result = out[offset + k];
+            result.year = values.year;
+            result.amete_alem = values.ameteAlem;
+            result.wenber = values.wenber;
+            result.abekte = values.abekte;
+            result.metqi = values.metqi;
+            result.wengelawi = values.wengelawiIndex;
+            for (int i = 0; i < FEAST_COUNT; i++) {
+                const CalendarDate& date = feasts[k].dates[i];
+                result.feasts[i] = {date.day, date.month, date.year};
+            }
+        }
+    }
+    return count;
+}
+
+}  // extern "C"
@@ -0,0 +1,162 @@
+// This file is for the extended-range calendar arithmetic
+// the calendar_core.h conversions redone in explicit 64-bit integers with floor division, so they hold
+// for negative JDNs and years (astronomical numbering: year 0 is the year before 1) over at least
+// ±1,000,000 years. The core stays the fast path: the extended* functions below use it whenever a
+// date lies inside its window and switch to the wide arithmetic only outside it.
+
+#pragma once  // prevent multiple inclusions
+#include "calendar_core.h"
+#include <cstdint>  // for std::int64_t
+
+// Years accepted by isValidExtendedDate, in every calendar
+constexpr std::int64_t EXTENDED_YEAR_LIMIT = 1000000;
+
+// The core's JDN -> date functions divide with `/`, which truncates toward zero; that only equals the
+// floor division their formulas need while the operands are non-negative, which is from the latest
+// epoch (the Hijri one) on. The upper end keeps every intermediate inside 32 bits, where `long` may be.
+constexpr std::int64_t NARROW_FIRST_JDN = ISLAMIC_EPOCH_JDN;
+constexpr std::int64_t NARROW_LAST_JDN = 50000000;  // about 132,000 CE
+
+constexpr bool fitsNarrowJDN(std::int64_t jdn) { return jdn >= NARROW_FIRST_JDN && jdn <= NARROW_LAST_JDN; }
+// The years isValidCalendarDate accepts; the core's date -> JDN functions are exact for them
+constexpr bool fitsNarrowYear(std::int64_t year) { return year >= 1 && year <= 5000; }
+
+// Floor division and the matching non-negative remainder, for b > 0
+constexpr std::int64_t floorDiv(std::int64_t a, std::int64_t b) { return a / b - (a % b < 0); }
+constexpr std::int64_t floorMod(std::int64_t a, std::int64_t b) { return a % b + (a % b < 0) * b; }
+
+struct ExtendedDate {
+    int day;
+    int month;
+    std::int64_t year;
+};
+
+// Gregorian and Julian count months from March, so the leap day ends the year:
+// day of that year for a date, and the date of a day of the year starting in March of `marchYear`
+constexpr int marchDayOfYear(int d, int m) { return (153 * ((m + 9) % 12) + 2) / 5 + d - 1; }
+constexpr ExtendedDate marchDate(int dayOfYear, std::int64_t marchYear) {
+    int monthIndex = (5 * dayOfYear + 2) / 153;  // 0 = March
+    int month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    return {dayOfYear - (153 * monthIndex + 2) / 5 + 1, month, marchYear + (month <= 2)};
+}
+
+constexpr std::int64_t GREGORIAN_MARCH_EPOCH_JDN = 1721120;  // 1 March of year 0, proleptic Gregorian
+constexpr std::int64_t JULIAN_MARCH_EPOCH_JDN = 1721118;     // 1 March of year 0, proleptic Julian
+
+// Wide arithmetic, per calendar tag
+template <typename Calendar>
+struct WideCalendar;
+
+// 400-year eras of 146097 days; inside an era every quantity is non-negative
+template <>
+struct WideCalendar<GregorianCalendar> {
+    static constexpr std::int64_t toJDN(int d, int m, std::int64_t y) {
+        std::int64_t marchYear = y - (m <= 2);
+        std::int64_t era = floorDiv(marchYear, 400);
+        std::int64_t yearOfEra = marchYear - era * 400;
+        return GREGORIAN_MARCH_EPOCH_JDN + era * 146097 + yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 +
+               marchDayOfYear(d, m);
+    }
+    static constexpr ExtendedDate fromJDN(std::int64_t jdn) {
+        std::int64_t era = floorDiv(jdn - GREGORIAN_MARCH_EPOCH_JDN, 146097);
+        std::int64_t dayOfEra = jdn - GREGORIAN_MARCH_EPOCH_JDN - era * 146097;
+        std::int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+        int dayOfYear = (int)(dayOfEra - (yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100));
+        return marchDate(dayOfYear, era * 400 + yearOfEra);
+    }
+};
+
+// The same with 4-year eras of 1461 days
+template <>
+struct WideCalendar<JulianCalendar> {
+    static constexpr std::int64_t toJDN(int d, int m, std::int64_t y) {
+        std::int64_t marchYear = y - (m <= 2);
+        std::int64_t era = floorDiv(marchYear, 4);
+        return JULIAN_MARCH_EPOCH_JDN + era * 1461 + (marchYear - era * 4) * 365 + marchDayOfYear(d, m);
+    }
+    static constexpr ExtendedDate fromJDN(std::int64_t jdn) {
+        std::int64_t era = floorDiv(jdn - JULIAN_MARCH_EPOCH_JDN, 1461);
+        std::int64_t dayOfEra = jdn - JULIAN_MARCH_EPOCH_JDN - era * 1461;
+        std::int64_t yearOfEra = (dayOfEra - dayOfEra / 1460) / 365;
+        return marchDate((int)(dayOfEra - yearOfEra * 365), era * 4 + yearOfEra);
+    }
+};
+
+// Ethiopian and Coptic: the core formulas with floor division, from each calendar's epoch
+template <std::int64_t EPOCH_JDN>
+struct WideAlexandrianCalendar {
+    static constexpr std::int64_t toJDN(int d, int m, std::int64_t y) {
+        return EPOCH_JDN - 1 + (y - 1) * 365 + floorDiv(y, 4) + (m - 1) * 30 + d;
+    }
+    static constexpr ExtendedDate fromJDN(std::int64_t jdn) {
+        std::int64_t year = floorDiv(4 * (jdn - EPOCH_JDN) + 1463, 1461);
+        int dayOfYear = (int)(jdn - toJDN(1, 1, year));
+        return {dayOfYear % 30 + 1, dayOfYear / 30 + 1, year};
+    }
+};
+
+template <>
+struct WideCalendar<EthiopianCalendar> : WideAlexandrianCalendar<ETHIOPIAN_EPOCH_JDN> {};
+template <>
+struct WideCalendar<CopticCalendar> : WideAlexandrianCalendar<COPTIC_EPOCH_JDN> {};
+
+// Tabular Hijri, as in the core
+template <>
+struct WideCalendar<IslamicCalendar> {
+    static constexpr std::int64_t toJDN(int d, int m, std::int64_t y) {
+        return (y - 1) * 354 + floorDiv(11 * y + 3, 30) + ISLAMIC_EPOCH_JDN + islamicMonthStart(m - 1) + d - 1;
+    }
+    static constexpr ExtendedDate fromJDN(std::int64_t jdn) {
+        std::int64_t year = floorDiv(30 * (jdn - ISLAMIC_EPOCH_JDN) + 10646, 10631);
+        int dayOfYear = (int)(jdn - toJDN(1, 1, year));
+        int monthIndex = islamicMonthOfDay(dayOfYear);
+        return {dayOfYear - islamicMonthStart(monthIndex) + 1, monthIndex + 1, year};
+    }
+};
+
+// Days in a month: the distance to the first of the next month, so no leap rule is repeated here
+template <typename Calendar>
+constexpr int wideMonthLength(int m, std::int64_t y) {
+    typedef WideCalendar<Calendar> Wide;
+    std::int64_t next = m < Calendar::monthsInYear ? Wide::toJDN(1, m + 1, y) : Wide::toJDN(1, 1, y + 1);
+    return (int)(next - Wide::toJDN(1, m, y));
+}
+
+constexpr CalendarDate toCalendarDate(const ExtendedDate& date) { return {date.day, date.month, (int)date.year}; }
+
+// Date <-> JDN for one calendar, through the core when it is exact there
+template <typename Calendar>
+constexpr std::int64_t extendedToJDN(int d, int m, std::int64_t y) {
+    return fitsNarrowYear(y) ? Calendar::toJDN(d, m, (int)y) : WideCalendar<Calendar>::toJDN(d, m, y);
+}
+template <typename Calendar>
+constexpr ExtendedDate extendedFromJDN(std::int64_t jdn) {
+    if (!fitsNarrowJDN(jdn)) return WideCalendar<Calendar>::fromJDN(jdn);
+    CalendarDate date = Calendar::fromJDN((long)jdn);
+    return {date.day, date.month, date.year};
+}
+
+// The same for a calendar chosen at run time
+constexpr std::int64_t extendedCalendarToJDN(CalendarType type, int d, int m, std::int64_t y) {
+    return visitCalendar(type, [d, m, y](auto calendar) { return extendedToJDN<decltype(calendar)>(d, m, y); });
+}
+constexpr ExtendedDate extendedCalendarFromJDN(CalendarType type, std::int64_t jdn) {
+    return visitCalendar(type, [jdn](auto calendar) { return extendedFromJDN<decltype(calendar)>(jdn); });
+}
+
+// Years -EXTENDED_YEAR_LIMIT to EXTENDED_YEAR_LIMIT (year 0 included) in every calendar
+constexpr bool isValidExtendedDate(int d, int m, std::int64_t y, CalendarType type) {
+    if (!isKnownCalendar(type) || y < -EXTENDED_YEAR_LIMIT || y > EXTENDED_YEAR_LIMIT) return false;
+    return visitCalendar(type, [d, m, y](auto calendar) {
+        typedef decltype(calendar) Calendar;
+        return m >= 1 && m <= Calendar::monthsInYear && d >= 1 && d <= wideMonthLength<Calendar>(m, y);
+    });
+}
+
+// convertJDNCore for any JDN whose years fit in an int (all of the extended range)
+constexpr ConvertedDate convertJDNExtended(std::int64_t jdn) {
+    if (fitsNarrowJDN(jdn)) return convertJDNCore((long)jdn);
+    return {(long)jdn, toCalendarDate(WideCalendar<GregorianCalendar>::fromJDN(jdn)),
+            toCalendarDate(WideCalendar<EthiopianCalendar>::fromJDN(jdn)),
+            toCalendarDate(WideCalendar<IslamicCalendar>::fromJDN(jdn)), (int)floorMod(jdn, 4)};
+}
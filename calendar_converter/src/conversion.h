@@ -4,24 +4,26 @@
 #pragma once  // prevent multiple inclusions
 // ensures that the header file is included only once
 #include "data.h"
+#include "calendar_core.h"  // constexpr core the functions below wrap
+#include "calendar_extended.h"  // 64-bit arithmetic for JDNs outside the core's window
 
 // JDN conversion functions
-long dateToJDN(int d, int m, int y, bool isGregorian = true);
+long dateToJDN(int d, int m, int y, bool isGregorian = true);  // Gregorian or Ethiopian
+long dateToJDN(int d, int m, int y, CalendarType type);          // any calendar
+// (exact for every JDN of the extended range, negative ones included; see calendar_extended.h)
 void jdnToEth(long jdn, int &d, int &m, int &y);
 void jdnToIslamic(long jdn, int &d, int &m, int &y);
 void jdnToGreg(long jdn, int &d, int &m, int &y);
 
+// Convert a JDN into every supported calendar at once (likewise)
+void convertJDN(long jdn, ConvertedDate& out);
+
 // Date validation
 bool isValidDate(int d, int m, int y, CalendarType type);
 
-// Date conversion
-void convertAndDisplayDate(int d, int m, int y, CalendarType sourceType);
-
 // Bahere Hasab functions
 
 // get tewsak
 int getTewsak(int dayIndex);
 // calculate Bahere Hasab
-void calculateBahereHasab(int inputYear, BahereHasabResults& results);
-// display Bahere Hasab results
-void displayBahereHasabResults(const BahereHasabResults& results);
\ No newline at end of file
+void calculateBahereHasab(int inputYear, BahereHasabResults& results);
\ No newline at end of file
@@ -1,11 +1,14 @@
 #pragma once
 #include <string>
+#include <vector>
 
 // Calendar type constants
 enum CalendarType {
     GREGORIAN = 1,
     ETHIOPIAN = 2,
-    ISLAMIC = 3
+    ISLAMIC = 3,
+    JULIAN = 4,   // input only: results are shown in the three calendars above
+    COPTIC = 5    // input only
 };
 
 // Bahere Hasab results structure
@@ -18,6 +21,22 @@ struct BahereHasabResults {
     const char* wengelawi;
 };
 
+// A day/month/year triple in a single calendar
+struct CalendarDate {
+    int day;
+    int month;
+    int year;
+};
+
+// One JDN expressed in every supported calendar
+struct ConvertedDate {
+    long jdn;
+    CalendarDate gregorian;
+    CalendarDate ethiopian;
+    CalendarDate islamic;
+    int ayyaana;  // index into SIDAMA_AYYAANA
+};
+
 // Calendar record structure
 struct CalendarRecord {
     int id;
@@ -32,10 +51,17 @@ extern const char* MONTHS_GEEZ[13];
 extern const char* MONTHS_HIJRI[12];
 extern const char* WENGELAWI_LIST[4];
 extern const char* SIDAMA_AYYAANA[4];
+extern const char* WEEKDAYS_GEEZ[7];  // Sunday first
 
-// Data management functions
-void addRecord(const CalendarRecord& record);
+// Data management functions (implemented in record_store.cpp)
+// Records live in fixed-size segments, so the pointer from findRecord stays valid until the record
+// is deleted or the store is reopened; change records through updateRecord so the change is journaled
+// Both reject a record with an unknown calendar or an invalid date (isValidDate)
+int addRecord(const CalendarRecord& record);  // assigns and returns a new id (record.id is ignored), 0 on failure
+bool updateRecord(int id, const CalendarRecord& record);
 bool deleteRecord(int id);
-CalendarRecord* findRecord(int id);
+const CalendarRecord* findRecord(int id);
 void showAllRecords();
-int getRecordCount();
\ No newline at end of file
+int getRecordCount();
+// Records whose date falls on JDN firstJdn..lastJdn, ordered by JDN
+std::vector<CalendarRecord> findRecordsInRange(long firstJdn, long lastJdn);
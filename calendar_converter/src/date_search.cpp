@@ -0,0 +1,155 @@
+#include "date_search.h"       // date search declarations
+#include "calendar_extended.h"  // conversions for any JDN
+#include <algorithm>            // for std::lower_bound / std::min_element
+
+// After `years` years every date of a calendar falls `days` days later
+struct CalendarCycle {
+    int years;
+    long days;
+};
+
+static CalendarCycle calendarCycle(CalendarType calendar) {
+    switch (calendar) {
+        case GREGORIAN: return {400, 146097};
+        case ISLAMIC: return {30, 10631};
+        default: return {4, 1461};  // Ethiopian, Julian, Coptic
+    }
+}
+
+static_assert(gregorianToJDN(1, 1, 401) - gregorianToJDN(1, 1, 1) == 146097 &&
+              islamicToJDN(1, 1, 31) - islamicToJDN(1, 1, 1) == 10631 &&
+              ethiopianToJDN(1, 1, 5) - ethiopianToJDN(1, 1, 1) == 1461 && julianToJDN(1, 1, 5) - julianToJDN(1, 1, 1) == 1461,
+              "calendar cycles");
+
+// The days matching a date constraint, as JDN residues modulo its cycle, ascending; empty if none can
+static std::vector<long> cycleResidues(const DateConstraint& constraint, long& cycleDays) {
+    std::vector<long> residues;
+    CalendarType calendar = constraint.calendar;
+    cycleDays = calendarCycle(calendar).days;
+    if (!isKnownCalendar(calendar) || constraint.month < 0 || constraint.month > monthsInYear(calendar) ||
+        constraint.day < 0 || constraint.day > 31) {
+        return residues;
+    }
+    for (int year = 1; year <= calendarCycle(calendar).years; year++) {
+        for (int month = 1; month <= monthsInYear(calendar); month++) {
+            if (constraint.month != 0 && month != constraint.month) continue;
+            int length = monthLength(month, year, calendar);
+            long first = calendarToJDN(calendar, 1, month, year);
+            for (int day = 1; day <= length; day++) {
+                if (constraint.day == 0 || day == constraint.day) residues.push_back((long)floorMod(first + day - 1, cycleDays));
+            }
+        }
+    }
+    std::sort(residues.begin(), residues.end());
+    return residues;
+}
+
+// Merge x = residue (mod modulus) with x = otherResidue (mod otherModulus), for coprime moduli
+static void mergeCongruence(long& residue, long& modulus, long otherResidue, long otherModulus) {
+    long x = residue;
+    while (x % otherModulus != otherResidue) x += modulus;
+    residue = x;
+    modulus *= otherModulus;
+}
+
+static long greatestCommonDivisor(long a, long b) {
+    while (b != 0) {
+        long rest = a % b;
+        a = b;
+        b = rest;
+    }
+    return a;
+}
+
+DateSearch::DateSearch(const DateSearchQuery& query, long firstJdn, long lastJdn)
+    : period(1), cycleStart(0), position(0), lastJdn(lastJdn), checked(0) {
+    // Weekday ((jdn + 1) mod 7) and Ayyaana (jdn mod 4) as one congruence jdn = residue (mod modulus)
+    long residue = 0, modulus = 1;
+    if (query.weekday > 6 || query.ayyaana > 3) return;
+    if (query.weekday >= 0) mergeCongruence(residue, modulus, (long)floorMod(query.weekday - 1, 7), 7);
+    if (query.ayyaana >= 0) mergeCongruence(residue, modulus, query.ayyaana, 4);
+
+    // The date constraint with the fewest days per cycle drives the search; the others are checked
+    std::vector<long> driver = {0};
+    long driverPeriod = 1;
+    std::size_t driverIndex = query.dates.size();
+    for (std::size_t i = 0; i < query.dates.size(); i++) {
+        long cycleDays;
+        std::vector<long> residues = cycleResidues(query.dates[i], cycleDays);
+        if (residues.empty()) return;
+        if ((double)residues.size() / (double)cycleDays < (double)driver.size() / (double)driverPeriod) {
+            driver.swap(residues);
+            driverPeriod = cycleDays;
+            driverIndex = i;
+        }
+    }
+    for (std::size_t i = 0; i < query.dates.size(); i++) {
+        if (i != driverIndex) checks.push_back(query.dates[i]);
+    }
+
+    // Each driver residue lifts to period / driverPeriod residues of the common period, of which
+    // those meeting the congruence remain (the Chinese remainder theorem, by enumeration)
+    period = driverPeriod / greatestCommonDivisor(driverPeriod, modulus) * modulus;
+    for (long lift = 0; lift < period; lift += driverPeriod) {
+        for (long offset : driver) {
+            if ((offset + lift) % modulus == residue) offsets.push_back(offset + lift);
+        }
+    }
+    if (firstJdn > lastJdn) offsets.clear();
+    if (offsets.empty()) return;
+
+    cycleStart = (long)floorDiv(firstJdn, period) * period;
+    position = (std::size_t)(std::lower_bound(offsets.begin(), offsets.end(), firstJdn - cycleStart) - offsets.begin());
+}
+
+bool DateSearch::matchesChecks(long jdn) const {
+    for (const DateConstraint& check : checks) {
+        ExtendedDate date = extendedCalendarFromJDN(check.calendar, jdn);
+        if ((check.month != 0 && date.month != check.month) || (check.day != 0 && date.day != check.day)) return false;
+    }
+    return true;
+}
+
+bool DateSearch::next(long& jdn) {
+    while (!offsets.empty()) {
+        if (position == offsets.size()) {
+            position = 0;
+            cycleStart += period;
+        }
+        long candidate = cycleStart + offsets[position++];
+        if (candidate > lastJdn) {
+            offsets.clear();
+            break;
+        }
+        if (checks.empty()) {
+            jdn = candidate;
+            return true;
+        }
+        checked++;
+        if (matchesChecks(candidate)) {
+            jdn = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool parseIndex(const std::string& name, const char* const* names, int count, int& index) {
+    for (int i = 0; i < count; i++) {
+        if (name == names[i] || name == std::to_string(i)) {
+            index = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseWeekday(const std::string& name, int& weekday) {
+    static const char* const NAMES[7] = {"sun", "mon", "tue", "wed", "thu", "fri", "sat"};
+    return parseIndex(name, NAMES, 7, weekday);
+}
+
+bool parseAyyaana(const std::string& name, int& ayyaana) {
+    static const char* const NAMES[4] = {"dora", "kor", "boka", "shefero"};
+    return parseIndex(name, NAMES, 4, ayyaana) || parseIndex(name, SIDAMA_AYYAANA, 4, ayyaana);
+}
@@ -0,0 +1,54 @@
+// This file is for the periodic date search
+// it lists the days that meet a set of constraints (weekday, Ayyaana, and a day and/or month in any
+// calendar) without converting every day. Weekday and Ayyaana are congruences on the JDN (mod 7 and
+// mod 4, merged into one mod 28), and a calendar date repeats with its calendar's cycle (1461 days
+// Ethiopian/Julian/Coptic, 10,631 Hijri, 146,097 Gregorian). The sparsest calendar constraint and the
+// congruence are merged into one sorted table of offsets over their common period, so the search
+// jumps from candidate to candidate and converts only those, to check the remaining constraints.
+
+#pragma once  // prevent multiple inclusions
+#include "data.h"
+#include <cstddef>  // for std::size_t
+#include <string>
+#include <vector>
+
+// A day and/or month of one calendar (0 for any), e.g. {ISLAMIC, 0, 1}: the 1st of every Hijri month
+struct DateConstraint {
+    CalendarType calendar;
+    int month;
+    int day;
+};
+
+struct DateSearchQuery {
+    int weekday = -1;  // 0 = Sunday .. 6 = Saturday, or -1 for any
+    int ayyaana = -1;  // index into SIDAMA_AYYAANA (the JDN mod 4), or -1 for any
+    std::vector<DateConstraint> dates;  // all must hold
+};
+
+// The days firstJdn..lastJdn that meet a query, produced one at a time in ascending order.
+// A query that no day can meet (month 14, day 31 of an Ethiopian month, weekday 9) yields nothing.
+class DateSearch {
+public:
+    DateSearch(const DateSearchQuery& query, long firstJdn, long lastJdn);
+
+    // The next matching day; false once the range is exhausted
+    bool next(long& jdn);
+
+    // Candidates converted so far (for comparison with a day-by-day scan)
+    unsigned long long candidates() const { return checked; }
+
+private:
+    bool matchesChecks(long jdn) const;
+
+    std::vector<DateConstraint> checks;  // constraints verified by conversion
+    std::vector<long> offsets;           // ascending, in [0, period)
+    long period;
+    long cycleStart;                     // JDN of offset 0 of the current period
+    std::size_t position;                // next entry of `offsets`
+    long lastJdn;
+    unsigned long long checked;
+};
+
+// "sun".."sat" (or 0-6) and "dora"/"kor"/"boka"/"shefero" (or 0-3, or the SIDAMA_AYYAANA name)
+bool parseWeekday(const std::string& name, int& weekday);
+bool parseAyyaana(const std::string& name, int& ayyaana);
@@ -0,0 +1,75 @@
+#include "display.h"        // console output declarations
+#include "conversion.h"     // for the conversions shown
+#include "bahere_hasab.h"   // precomputed Paschal-cycle feast table
+#include "format.h"         // renders results into a fixed buffer
+#include "history_log.h"    // binary conversion history (history.bin)
+#include "lookup_table.h"   // precomputed table consulted before the arithmetic
+#include "metrics.h"        // counters and latency histograms (compiled out unless CALENDAR_METRICS)
+#include "report_writer.h"  // background writer for report.txt / holidays_report.txt
+#include <cstdio>           // one fwrite per result
+#include <cstring>          // for std::memchr
+#include <iostream>
+
+// Log holiday data to file (queued; the background writer adds the timestamp)
+void writeHolidaysReport(const std::string& content) {
+    submitReport(HOLIDAYS_REPORT, content);
+}
+
+
+// Process and print moveable Ethiopian holidays
+// (formatted once: the report gets the whole text, the screen only the feast lines after the 2-line header)
+void displayBahereHasabResults(const BahereHasabResults& res) {
+    MetricTimer timer(METRIC_BAHERE_HASAB_DISPLAY);
+    countMetric(METRIC_BAHERE_HASAB);
+    MoveableFeasts feasts = feastsForYear(res.year);
+
+    char text[FORMAT_BUFFER_BYTES];
+    std::size_t length = formatBahereHasab(res, feasts, FORMAT_HUMAN, text, sizeof(text));
+    const char* end = text + length;
+    const char* feastLines = text;
+    for (int line = 0; line < 2 && feastLines != end; line++) {
+        feastLines = static_cast<const char*>(std::memchr(feastLines, '\n', (std::size_t)(end - feastLines))) + 1;
+    }
+    std::fwrite(feastLines, 1, (std::size_t)(end - feastLines), stdout);
+    std::fputs("\n✓ Holidays saved to holidays_report.txt\n", stdout);
+    std::fflush(stdout);
+
+    writeHolidaysReport(std::string(text, length));
+}
+
+
+// Log conversion history to file (queued; the background writer adds the timestamp)
+void writeToReport(const std::string& content) {
+    submitReport(CONVERSION_REPORT, content);
+}
+
+
+// Master function to convert and display dates across systems
+void convertAndDisplayDate(int d, int m, int y, CalendarType sourceType) {
+    if (!isValidDate(d, m, y, sourceType)) {
+        std::cout << "⚠️ Invalid date!" << std::endl;
+        return;
+    }
+
+    MetricTimer timer(sourceType, TO_ALL_CALENDARS);
+    countConversions(sourceType, TO_ALL_CALENDARS);
+    long jdn = calendarToJDN(sourceType, d, m, y);
+    
+    // Served from the mmap'd lookup table when one is loaded, computed otherwise
+    ConvertedDate date;
+    lookupDate(jdn, date);
+    displayConvertedDate(date, sourceType);
+}
+
+// Print a converted date and log it to the report and the history
+void displayConvertedDate(const ConvertedDate& date, CalendarType sourceType) {
+    // Formatted once: the screen gets a leading blank line, the report the text without the final newline
+    char text[FORMAT_BUFFER_BYTES];
+    text[0] = '\n';
+    std::size_t length = formatConversion(date, FORMAT_HUMAN, text + 1, sizeof(text) - 1);
+    std::fwrite(text, 1, length + 1, stdout);
+    std::fflush(stdout);
+
+    writeToReport(std::string(text + 1, length > 0 ? length - 1 : 0));
+    appendHistory(date.jdn, sourceType);
+}
@@ -0,0 +1,14 @@
+// This file is for the console output of conversions
+// it prints results and logs them to the report files and the history; the conversions themselves
+// (conversion.h) do no I/O, so the library is built without this file
+
+#pragma once  // prevent multiple inclusions
+#include "data.h"
+
+// Convert a date, print it in every calendar and log it
+void convertAndDisplayDate(int d, int m, int y, CalendarType sourceType);
+// The display, report and history part of convertAndDisplayDate, for a date converted already
+void displayConvertedDate(const ConvertedDate& date, CalendarType sourceType);
+
+// Print the moveable feasts of a Bahere Hasab result and log them to holidays_report.txt
+void displayBahereHasabResults(const BahereHasabResults& results);
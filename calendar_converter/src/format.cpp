@@ -0,0 +1,404 @@
+#include "format.h"  // formatter declarations
+#include "year_grid.h"  // for YearGrid
+#include <cstring>   // for std::memcpy / std::strlen
+
+// A name and its length in bytes; the names are Ge'ez script, three UTF-8 bytes per character
+struct Text {
+    const char* bytes;
+    std::size_t length;
+};
+
+template <std::size_t N>
+constexpr Text literal(const char (&text)[N]) {
+    return {text, N - 1};
+}
+
+const Text FEAST_NAMES[FEAST_COUNT] = {literal("ጾመ ነነዌ"), literal("ዐቢይ ጾም"), literal("ደብረ ዘይት"),
+                                       literal("ሆሣዕና"), literal("ስቅለት"), literal("ትንሣኤ (ፋሲካ)")};
+// Feast names are padded to this many bytes in the human template (as std::setw(18) did)
+const std::size_t FEAST_NAME_BYTES = 18;
+
+// Byte lengths of the data.cpp name tables, measured once at startup
+struct NameTables {
+    Text geez[13];
+    Text hijri[12];
+    Text wengelawi[4];
+    Text ayyaana[4];
+    Text weekdays[7];
+
+    NameTables() {
+        measure(MONTHS_GEEZ, geez, 13);
+        measure(MONTHS_HIJRI, hijri, 12);
+        measure(WENGELAWI_LIST, wengelawi, 4);
+        measure(SIDAMA_AYYAANA, ayyaana, 4);
+        measure(WEEKDAYS_GEEZ, weekdays, 7);
+    }
+
+    static void measure(const char* const* names, Text* out, int count) {
+        for (int i = 0; i < count; i++) out[i] = {names[i], std::strlen(names[i])};
+    }
+};
+static const NameTables names;
+
+// Entry `index` of a name table, or "?" for an index outside it
+static Text nameAt(const Text* table, int count, int index) {
+    return index >= 0 && index < count ? table[index] : literal("?");
+}
+
+// results.wengelawi normally points into WENGELAWI_LIST; anything else is measured here
+static Text wengelawiName(const char* name) {
+    for (const Text& known : names.wengelawi) {
+        if (known.bytes == name) return known;
+    }
+    return name ? Text{name, std::strlen(name)} : literal("?");
+}
+
+// "00" .. "99", for writing numbers two digits at a time
+struct DigitPairs {
+    char text[200] = {};
+    constexpr DigitPairs() {
+        for (int i = 0; i < 100; i++) {
+            text[2 * i] = (char)('0' + i / 10);
+            text[2 * i + 1] = (char)('0' + i % 10);
+        }
+    }
+};
+constexpr DigitPairs DIGIT_PAIRS;
+
+// Appends to a fixed buffer; once something does not fit, everything after it is dropped
+class TextWriter {
+public:
+    TextWriter(char* out, std::size_t capacity) : begin(out), p(out), end(out + capacity) {}
+
+    void text(const char* bytes, std::size_t length) {
+        if (length > (std::size_t)(end - p)) {
+            overflow = true;
+            return;
+        }
+        std::memcpy(p, bytes, length);
+        p += length;
+    }
+    void text(const Text& t) { text(t.bytes, t.length); }
+    template <std::size_t N>
+    void text(const char (&bytes)[N]) { text(bytes, N - 1); }
+
+    void number(long value) {
+        char digits[24];
+        char* last = digits + sizeof(digits);
+        char* d = last;
+        unsigned long magnitude = value < 0 ? 0ul - (unsigned long)value : (unsigned long)value;
+        while (magnitude >= 100) {
+            const char* pair = DIGIT_PAIRS.text + 2 * (magnitude % 100);
+            magnitude /= 100;
+            *--d = pair[1];
+            *--d = pair[0];
+        }
+        if (magnitude >= 10) {
+            *--d = DIGIT_PAIRS.text[2 * magnitude + 1];
+            *--d = DIGIT_PAIRS.text[2 * magnitude];
+        } else {
+            *--d = (char)('0' + magnitude);
+        }
+        if (value < 0) *--d = '-';
+        text(d, (std::size_t)(last - d));
+    }
+
+    void spaces(std::size_t count) {
+        while (count-- > 0) text(" ");
+    }
+
+    // d/m/y
+    void date(const CalendarDate& date) {
+        number(date.day);
+        text("/");
+        number(date.month);
+        text("/");
+        number(date.year);
+    }
+
+    // A JSON string; only '"' and '\' need escaping in the name tables
+    void jsonString(const Text& t) {
+        text("\"");
+        for (std::size_t i = 0; i < t.length; i++) {
+            if (t.bytes[i] == '"' || t.bytes[i] == '\\') text("\\");
+            text(t.bytes + i, 1);
+        }
+        text("\"");
+    }
+
+    // {"day":d,"month":m,"year":y[,"monthName":"..."]}
+    void jsonDate(const CalendarDate& date, const Text* monthName) {
+        text("{\"day\":");
+        number(date.day);
+        text(",\"month\":");
+        number(date.month);
+        text(",\"year\":");
+        number(date.year);
+        if (monthName) {
+            text(",\"monthName\":");
+            jsonString(*monthName);
+        }
+        text("}");
+    }
+
+    std::size_t finish() const { return overflow ? 0 : (std::size_t)(p - begin); }
+
+private:
+    char* begin;
+    char* p;
+    char* end;
+    bool overflow = false;
+};
+
+bool parseFormatTemplate(const std::string& name, FormatTemplate& format) {
+    if (name == "human") format = FORMAT_HUMAN;
+    else if (name == "csv") format = FORMAT_CSV;
+    else if (name == "json") format = FORMAT_JSON;
+    else return false;
+    return true;
+}
+
+std::size_t formatConversion(const ConvertedDate& date, FormatTemplate format, char* out, std::size_t capacity) {
+    const CalendarDate& greg = date.gregorian;
+    const CalendarDate& eth = date.ethiopian;
+    const CalendarDate& hijri = date.islamic;
+    Text ethMonth = nameAt(names.geez, 13, eth.month - 1);
+    Text hijriMonth = nameAt(names.hijri, 12, hijri.month - 1);
+    Text ayyaana = nameAt(names.ayyaana, 4, date.ayyaana);
+
+    TextWriter w(out, capacity);
+    switch (format) {
+        case FORMAT_HUMAN:
+            w.text("=== Date Conversion ===\nGregorian (GC)     : ");
+            w.date(greg);
+            w.text("\nEthiopian (EC)     : ");
+            w.text(ethMonth);
+            w.text(" ");
+            w.number(eth.day);
+            w.text(", ");
+            w.number(eth.year);
+            w.text(" ዓ.ም\nIslamic (Hijri)    : ");
+            w.number(hijri.day);
+            w.text(" ");
+            w.text(hijriMonth);
+            w.text(" ");
+            w.number(hijri.year);
+            w.text(" AH\nSidama Ayyaana     : ");
+            w.text(ayyaana);
+            w.text("\n");
+            break;
+        case FORMAT_CSV:
+            w.number(date.jdn);
+            w.text(",");
+            w.date(greg);
+            w.text(",");
+            w.date(eth);
+            w.text(",");
+            w.date(hijri);
+            w.text(",");
+            w.text(ayyaana);
+            w.text("\n");
+            break;
+        case FORMAT_JSON:
+            w.text("{\"jdn\":");
+            w.number(date.jdn);
+            w.text(",\"gregorian\":");
+            w.jsonDate(greg, nullptr);
+            w.text(",\"ethiopian\":");
+            w.jsonDate(eth, &ethMonth);
+            w.text(",\"islamic\":");
+            w.jsonDate(hijri, &hijriMonth);
+            w.text(",\"ayyaana\":");
+            w.jsonString(ayyaana);
+            w.text("}\n");
+            break;
+    }
+    return w.finish();
+}
+
+// "ዘመነ <wengelawi> | አበቅቴ: <abekte> | መጥቅዕ: <metqi>"
+static void writeBahereHasabLine(TextWriter& w, const Text& wengelawi, int abekte, int metqi) {
+    w.text("ዘመነ ");
+    w.text(wengelawi);
+    w.text(" | አበቅቴ: ");
+    w.number(abekte);
+    w.text(" | መጥቅዕ: ");
+    w.number(metqi);
+    w.text("\n");
+}
+
+std::size_t formatBahereHasab(const BahereHasabResults& results, const MoveableFeasts& feasts, FormatTemplate format,
+                              char* out, std::size_t capacity) {
+    Text wengelawi = wengelawiName(results.wengelawi);
+
+    TextWriter w(out, capacity);
+    switch (format) {
+        case FORMAT_HUMAN:
+            w.text("--- ");
+            w.number(results.year);
+            w.text(" ዓ.ም የባሕረ ሐሳብ ውጤት ---\n");
+            writeBahereHasabLine(w, wengelawi, results.abekte, results.metqi);
+            for (int i = 0; i < FEAST_COUNT; i++) {
+                const CalendarDate& date = feasts.dates[i];
+                w.text(FEAST_NAMES[i]);
+                if (FEAST_NAMES[i].length < FEAST_NAME_BYTES) w.spaces(FEAST_NAME_BYTES - FEAST_NAMES[i].length);
+                w.text(" : ");
+                w.text(nameAt(names.geez, 13, date.month - 1));
+                w.text(" ");
+                w.number(date.day);
+                w.text("\n");
+            }
+            break;
+        case FORMAT_CSV:
+            // year,ameteAlem,wengelawi,wenber,abekte,metqi, then each feast as d/m/y
+            w.number(results.year);
+            w.text(",");
+            w.number(results.ameteAlem);
+            w.text(",");
+            w.text(wengelawi);
+            w.text(",");
+            w.number(results.wenber);
+            w.text(",");
+            w.number(results.abekte);
+            w.text(",");
+            w.number(results.metqi);
+            for (int i = 0; i < FEAST_COUNT; i++) {
+                w.text(",");
+                w.date(feasts.dates[i]);
+            }
+            w.text("\n");
+            break;
+        case FORMAT_JSON:
+            w.text("{\"year\":");
+            w.number(results.year);
+            w.text(",\"ameteAlem\":");
+            w.number(results.ameteAlem);
+            w.text(",\"wengelawi\":");
+            w.jsonString(wengelawi);
+            w.text(",\"wenber\":");
+            w.number(results.wenber);
+            w.text(",\"abekte\":");
+            w.number(results.abekte);
+            w.text(",\"metqi\":");
+            w.number(results.metqi);
+            w.text(",\"feasts\":[");
+            for (int i = 0; i < FEAST_COUNT; i++) {
+                Text month = nameAt(names.geez, 13, feasts.dates[i].month - 1);
+                if (i > 0) w.text(",");
+                w.text("{\"name\":");
+                w.jsonString(FEAST_NAMES[i]);
+                w.text(",\"date\":");
+                w.jsonDate(feasts.dates[i], &month);
+                w.text("}");
+            }
+            w.text("]}\n");
+            break;
+    }
+    return w.finish();
+}
+
+std::size_t formatYearGrid(const YearGrid& grid, FormatTemplate format, char* out, std::size_t capacity) {
+    const BahereHasabValues& values = grid.bahereHasab;
+    Text wengelawi = nameAt(names.wengelawi, 4, values.wengelawiIndex);
+
+    TextWriter w(out, capacity);
+    if (format == FORMAT_HUMAN) {
+        w.text("=== ");
+        w.number(grid.year);
+        w.text(" ዓ.ም ===\n");
+        writeBahereHasabLine(w, wengelawi, values.abekte, values.metqi);
+    } else if (format == FORMAT_JSON) {
+        w.text("{\"year\":");
+        w.number(grid.year);
+        w.text(",\"ameteAlem\":");
+        w.number(values.ameteAlem);
+        w.text(",\"wengelawi\":");
+        w.jsonString(wengelawi);
+        w.text(",\"wenber\":");
+        w.number(values.wenber);
+        w.text(",\"abekte\":");
+        w.number(values.abekte);
+        w.text(",\"metqi\":");
+        w.number(values.metqi);
+        w.text(",\"days\":[");
+    }
+
+    for (int i = 0; i < grid.dayCount; i++) {
+        const GridDay& day = grid.days[i];
+        int ethMonth = i / 30 + 1;
+        int ethDay = i % 30 + 1;
+        CalendarDate greg = {day.gregorianDay, day.gregorianMonth, day.gregorianYear};
+        CalendarDate hijri = {day.islamicDay, day.islamicMonth, day.islamicYear};
+        Text monthName = nameAt(names.geez, 13, ethMonth - 1);
+        Text hijriMonth = nameAt(names.hijri, 12, hijri.month - 1);
+        Text weekday = nameAt(names.weekdays, 7, day.weekday);
+        Text ayyaana = nameAt(names.ayyaana, 4, day.ayyaana);
+        bool feast = day.feast != GRID_NO_FEAST;
+
+        switch (format) {
+            case FORMAT_HUMAN:
+                // "--- <month> ---", then "<day> <weekday> | d/m/y | d <month> y AH | <ayyaana>[ | <feast>]"
+                if (ethDay == 1) {
+                    w.text("--- ");
+                    w.text(monthName);
+                    w.text(" ---\n");
+                }
+                if (ethDay < 10) w.text(" ");
+                w.number(ethDay);
+                w.text(" ");
+                w.text(weekday);
+                w.text(" | ");
+                w.date(greg);
+                w.text(" | ");
+                w.number(hijri.day);
+                w.text(" ");
+                w.text(hijriMonth);
+                w.text(" ");
+                w.number(hijri.year);
+                w.text(" AH | ");
+                w.text(ayyaana);
+                if (feast) {
+                    w.text(" | ");
+                    w.text(FEAST_NAMES[day.feast]);
+                }
+                w.text("\n");
+                break;
+            case FORMAT_CSV:
+                w.date({ethDay, ethMonth, grid.year});
+                w.text(",");
+                w.text(weekday);
+                w.text(",");
+                w.date(greg);
+                w.text(",");
+                w.date(hijri);
+                w.text(",");
+                w.text(ayyaana);
+                w.text(",");
+                if (feast) w.text(FEAST_NAMES[day.feast]);
+                w.text("\n");
+                break;
+            case FORMAT_JSON:
+                if (i > 0) w.text(",");
+                w.text("{\"month\":");
+                w.number(ethMonth);
+                w.text(",\"day\":");
+                w.number(ethDay);
+                w.text(",\"weekday\":");
+                w.jsonString(weekday);
+                w.text(",\"gregorian\":");
+                w.jsonDate(greg, nullptr);
+                w.text(",\"islamic\":");
+                w.jsonDate(hijri, &hijriMonth);
+                w.text(",\"ayyaana\":");
+                w.jsonString(ayyaana);
+                if (feast) {
+                    w.text(",\"feast\":");
+                    w.jsonString(FEAST_NAMES[day.feast]);
+                }
+                w.text("}");
+                break;
+        }
+    }
+    if (format == FORMAT_JSON) w.text("]}\n");
+    return w.finish();
+}
@@ -0,0 +1,41 @@
+// This file is for the result formatter
+// it renders conversion results and Bahere Hasab feasts as text into a caller-provided buffer,
+// without allocating, so each result can be written to the console or a report in one call
+
+#pragma once  // prevent multiple inclusions
+#include "calendar_core.h"  // for ConvertedDate / MoveableFeasts
+#include <cstddef>          // for std::size_t
+#include <string>
+
+// Output templates
+enum FormatTemplate {
+    FORMAT_HUMAN,  // the labelled lines shown on screen and in the report files
+    FORMAT_CSV,    // one row: jdn,gregorian,ethiopian,islamic,ayyaana (dates as d/m/y)
+    FORMAT_JSON    // one object per result
+};
+
+// "human", "csv" or "json"; returns false for anything else
+bool parseFormatTemplate(const std::string& name, FormatTemplate& format);
+
+// Large enough for any result in any template
+const std::size_t FORMAT_BUFFER_BYTES = 1024;
+
+// Render one conversion result into out[0 .. capacity).
+// Returns the number of bytes written (no terminating NUL), or 0 if the text does not fit.
+// Every template ends with '\n'.
+std::size_t formatConversion(const ConvertedDate& date, FormatTemplate format, char* out, std::size_t capacity);
+
+// Render the Bahere Hasab numbers and the moveable feasts of one year, same contract as formatConversion
+std::size_t formatBahereHasab(const BahereHasabResults& results, const MoveableFeasts& feasts, FormatTemplate format,
+                              char* out, std::size_t capacity);
+
+struct YearGrid;  // year_grid.h
+
+// Large enough for a year grid in any template
+const std::size_t YEAR_GRID_TEXT_BYTES = 128 * 1024;
+
+// Render a whole year grid, same contract as formatConversion:
+// human: a header with the Bahere Hasab numbers, then one line per day grouped by month;
+// CSV: one row per day: ethiopian,weekday,gregorian,islamic,ayyaana,feast (dates as d/m/y, feast may be empty);
+// JSON: one object per year on a single line
+std::size_t formatYearGrid(const YearGrid& grid, FormatTemplate format, char* out, std::size_t capacity);
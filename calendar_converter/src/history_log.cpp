@@ -0,0 +1,242 @@
+#include "history_log.h"  // binary history declarations
+#include "conversion.h"   // to render records on demand
+#include "today.h"        // for the record times
+#include <algorithm>      // for std::min / std::max
+#include <cstdio>         // for std::FILE
+#include <cstring>        // for std::memcmp / std::memcpy
+#include <ctime>          // for timestamps
+#include <mutex>
+
+#ifdef _WIN32
+#include <io.h>      // for _chsize_s
+#else
+#include <unistd.h>  // for ftruncate
+#endif
+
+// Appender state: the file stays open in append mode and stdio buffers the 16-byte records
+static std::mutex appendMutex;
+static std::FILE* appendFile = nullptr;
+static char appendBuffer[64 * 1024];
+
+static void closeAppendFile() {
+    if (appendFile) {
+        std::fclose(appendFile);
+        appendFile = nullptr;
+    }
+}
+
+// Closes (and so flushes) the appender at exit
+struct HistoryShutdown {
+    ~HistoryShutdown() {
+        std::lock_guard<std::mutex> lock(appendMutex);
+        closeAppendFile();
+    }
+};
+static HistoryShutdown shutdownAtExit;
+
+static bool isCurrentHeader(const HistoryLogHeader& header) {
+    return std::memcmp(header.magic, HISTORY_LOG_MAGIC, sizeof(header.magic)) == 0 &&
+           header.version == HISTORY_LOG_VERSION && header.recordSize == sizeof(HistoryRecord);
+}
+
+// Whether the history file is missing, empty, or starts with a complete header of this layout
+static bool isAppendable() {
+    std::FILE* in = std::fopen(HISTORY_LOG_FILE, "rb");
+    if (!in) return true;
+    HistoryLogHeader header;
+    std::size_t read = std::fread(&header, 1, sizeof(header), in);
+    std::fclose(in);
+    return read == 0 || (read == sizeof(header) && isCurrentHeader(header));
+}
+
+static bool truncateAppendFile(long size) {
+    std::fflush(appendFile);
+#ifdef _WIN32
+    return _chsize_s(_fileno(appendFile), size) == 0;
+#else
+    return ftruncate(fileno(appendFile), size) == 0;
+#endif
+}
+
+static bool openAppendFile() {
+    // A header torn by a crash during the first write, or one of another layout, would leave every
+    // record appended after it unreadable; such a file starts over
+    bool startOver = !isAppendable();
+
+    appendFile = std::fopen(HISTORY_LOG_FILE, "ab");
+    if (!appendFile) return false;
+    std::setvbuf(appendFile, appendBuffer, _IOFBF, sizeof(appendBuffer));
+
+    std::fseek(appendFile, 0, SEEK_END);
+    long size = std::ftell(appendFile);
+    if (startOver && size > 0) {
+        if (!truncateAppendFile(0)) {
+            closeAppendFile();
+            return false;
+        }
+        size = 0;
+    }
+
+    // A new (empty) file starts with the header
+    if (size == 0) {
+        HistoryLogHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, HISTORY_LOG_MAGIC, sizeof(header.magic));
+        header.version = HISTORY_LOG_VERSION;
+        header.recordSize = sizeof(HistoryRecord);
+        std::fwrite(&header, sizeof(header), 1, appendFile);
+    } else {
+        // Cut off a record torn by a crash so new records stay aligned
+        long torn = (size - (long)sizeof(HistoryLogHeader)) % (long)sizeof(HistoryRecord);
+        if (torn != 0 && !truncateAppendFile(size - torn)) {
+            closeAppendFile();
+            return false;
+        }
+    }
+    return true;
+}
+
+void appendHistory(long jdn, CalendarType sourceType) {
+    HistoryRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.timestamp = (std::int64_t)std::time(nullptr);
+    record.jdn = (std::int32_t)jdn;
+    record.sourceCalendar = (std::uint8_t)sourceType;
+
+    std::lock_guard<std::mutex> lock(appendMutex);
+    if (!appendFile && !openAppendFile()) return;
+    std::fwrite(&record, sizeof(record), 1, appendFile);
+}
+
+void flushHistory() {
+    std::lock_guard<std::mutex> lock(appendMutex);
+    if (appendFile) std::fflush(appendFile);
+}
+
+bool clearHistory() {
+    std::lock_guard<std::mutex> lock(appendMutex);
+    closeAppendFile();
+    return std::remove(HISTORY_LOG_FILE) == 0;
+}
+
+bool HistoryLog::load(const std::string& path) {
+    timestamps.clear();
+    jdns.clear();
+    sources.clear();
+    zones.clear();
+
+    std::FILE* in = std::fopen(path.c_str(), "rb");
+    if (!in) return false;
+
+    HistoryLogHeader header;
+    if (std::fread(&header, sizeof(header), 1, in) != 1 || !isCurrentHeader(header)) {
+        std::fclose(in);
+        return false;
+    }
+
+    std::fseek(in, 0, SEEK_END);
+    long fileSize = std::ftell(in);
+    std::fseek(in, sizeof(header), SEEK_SET);
+    std::size_t expected = fileSize > (long)sizeof(header) ? (fileSize - sizeof(header)) / sizeof(HistoryRecord) : 0;
+    timestamps.reserve(expected);
+    jdns.reserve(expected);
+    sources.reserve(expected);
+
+    // Read in large blocks and transpose into columns; fread of whole records drops a torn tail
+    std::vector<HistoryRecord> block(16384);
+    std::size_t count;
+    while ((count = std::fread(block.data(), sizeof(HistoryRecord), block.size(), in)) > 0) {
+        for (std::size_t i = 0; i < count; i++) {
+            timestamps.push_back(block[i].timestamp);
+            jdns.push_back(block[i].jdn);
+            sources.push_back(block[i].sourceCalendar);
+        }
+    }
+    std::fclose(in);
+
+    for (std::size_t start = 0; start < timestamps.size(); start += ZONE_SIZE) {
+        std::size_t end = std::min(start + ZONE_SIZE, timestamps.size());
+        Zone zone = {timestamps[start], timestamps[start], jdns[start], jdns[start]};
+        for (std::size_t i = start + 1; i < end; i++) {
+            zone.minTimestamp = std::min(zone.minTimestamp, timestamps[i]);
+            zone.maxTimestamp = std::max(zone.maxTimestamp, timestamps[i]);
+            zone.minJdn = std::min(zone.minJdn, jdns[i]);
+            zone.maxJdn = std::max(zone.maxJdn, jdns[i]);
+        }
+        zones.push_back(zone);
+    }
+    return true;
+}
+
+HistoryRecord HistoryLog::record(std::size_t index) const {
+    HistoryRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.timestamp = timestamps[index];
+    record.jdn = jdns[index];
+    record.sourceCalendar = sources[index];
+    return record;
+}
+
+std::vector<std::size_t> HistoryLog::queryByTime(std::int64_t from, std::int64_t to) const {
+    std::vector<std::size_t> matches;
+    for (std::size_t z = 0; z < zones.size(); z++) {
+        if (zones[z].maxTimestamp < from || zones[z].minTimestamp > to) continue;
+        std::size_t end = std::min((z + 1) * ZONE_SIZE, timestamps.size());
+        for (std::size_t i = z * ZONE_SIZE; i < end; i++) {
+            if (timestamps[i] >= from && timestamps[i] <= to) matches.push_back(i);
+        }
+    }
+    return matches;
+}
+
+std::vector<std::size_t> HistoryLog::queryByJDN(long from, long to) const {
+    std::vector<std::size_t> matches;
+    for (std::size_t z = 0; z < zones.size(); z++) {
+        if (zones[z].maxJdn < from || zones[z].minJdn > to) continue;
+        std::size_t end = std::min((z + 1) * ZONE_SIZE, jdns.size());
+        for (std::size_t i = z * ZONE_SIZE; i < end; i++) {
+            if (jdns[i] >= from && jdns[i] <= to) matches.push_back(i);
+        }
+    }
+    return matches;
+}
+
+std::string HistoryLog::describe(std::size_t index) const {
+    static const char* SOURCE_NAMES[] = {"?", "GC", "EC", "AH", "JC", "AM"};
+
+    char when[LOCAL_TIMESTAMP_BYTES];
+    formatLocalTimestamp((std::time_t)timestamps[index], when);
+
+    ConvertedDate date;
+    convertJDN(jdns[index], date);
+    int source = sources[index] <= COPTIC ? sources[index] : 0;
+
+    char line[256];
+    std::snprintf(line, sizeof(line), "[%s] from %s | GC %d/%d/%d | EC %s %d, %d | AH %d %s %d | %s",
+                  when, SOURCE_NAMES[source],
+                  date.gregorian.day, date.gregorian.month, date.gregorian.year,
+                  MONTHS_GEEZ[date.ethiopian.month - 1], date.ethiopian.day, date.ethiopian.year,
+                  date.islamic.day, MONTHS_HIJRI[date.islamic.month - 1], date.islamic.year,
+                  SIDAMA_AYYAANA[date.ayyaana]);
+    return line;
+}
+
+bool HistoryLog::exportColumns(const std::string& path) const {
+    std::FILE* out = std::fopen(path.c_str(), "wb");
+    if (!out) return false;
+
+    HistoryLogHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, HISTORY_LOG_MAGIC, sizeof(header.magic));
+    header.version = HISTORY_LOG_VERSION;
+    header.recordSize = 0;  // columnar layout
+    std::uint64_t count = timestamps.size();
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1 &&
+              std::fwrite(&count, sizeof(count), 1, out) == 1 &&
+              std::fwrite(timestamps.data(), sizeof(std::int64_t), count, out) == count &&
+              std::fwrite(jdns.data(), sizeof(std::int32_t), count, out) == count &&
+              std::fwrite(sources.data(), sizeof(std::uint8_t), count, out) == count;
+    ok = (std::fclose(out) == 0) && ok;
+    return ok;
+}
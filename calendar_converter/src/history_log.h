@@ -0,0 +1,80 @@
+// This file is for the binary conversion history
+// every conversion appends a fixed-width record (time, source calendar, JDN) to history.bin;
+// HistoryLog loads it into columns with a sparse zone-map index for fast range queries,
+// and the human-readable view is generated only for the records a query returns
+
+#pragma once  // prevent multiple inclusions
+#include "data.h"
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for fixed-width integer types
+#include <string>
+#include <vector>
+
+const char* const HISTORY_LOG_FILE = "history.bin";
+const char* const HISTORY_EXPORT_FILE = "history_columns.bin";  // default target of the columnar export
+
+// Bump HISTORY_LOG_VERSION whenever the layout below changes
+const char HISTORY_LOG_MAGIC[8] = {'C', 'H', 'R', 'O', 'N', 'H', 'I', 'S'};
+const std::uint32_t HISTORY_LOG_VERSION = 1;
+
+// File header, followed by HistoryRecord entries in append order
+struct HistoryLogHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t recordSize;
+};
+
+// One conversion, 16 bytes
+struct HistoryRecord {
+    std::int64_t timestamp;        // seconds since the Unix epoch
+    std::int32_t jdn;              // the converted day
+    std::uint8_t sourceCalendar;   // CalendarType the user entered
+    std::uint8_t reserved[3];
+};
+
+// Append a record stamped with the current time (buffered; see flushHistory)
+void appendHistory(long jdn, CalendarType sourceType);
+// Push buffered records to disk; call before reading the log from the same process
+void flushHistory();
+// Delete the history file
+bool clearHistory();
+
+// Read-only, columnar view of a history file
+class HistoryLog {
+public:
+    // Records per zone in the sparse index
+    static const std::size_t ZONE_SIZE = 1024;
+
+    // Load `path`; a trailing partial record (interrupted append) is ignored.
+    // Returns false if the file is missing or has a bad header.
+    bool load(const std::string& path = HISTORY_LOG_FILE);
+
+    std::size_t size() const { return timestamps.size(); }
+    HistoryRecord record(std::size_t index) const;
+
+    // Indices of the records with from <= timestamp <= to / from <= jdn <= to, in append order
+    std::vector<std::size_t> queryByTime(std::int64_t from, std::int64_t to) const;
+    std::vector<std::size_t> queryByJDN(long from, long to) const;
+
+    // Human-readable line for one record, e.g. "[2024-09-07 10:15:00] GC 7/9/2024 | EC ... | AH ..."
+    std::string describe(std::size_t index) const;
+
+    // Write the columns as one file: HistoryLogHeader (recordSize = 0), record count (uint64),
+    // then all timestamps (int64), all JDNs (int32) and all source calendars (uint8)
+    bool exportColumns(const std::string& path) const;
+
+private:
+    // Min/max of each column over ZONE_SIZE consecutive records; zones that cannot
+    // match a query are skipped without touching their records
+    struct Zone {
+        std::int64_t minTimestamp;
+        std::int64_t maxTimestamp;
+        std::int32_t minJdn;
+        std::int32_t maxJdn;
+    };
+
+    std::vector<std::int64_t> timestamps;
+    std::vector<std::int32_t> jdns;
+    std::vector<std::uint8_t> sources;
+    std::vector<Zone> zones;
+};
@@ -0,0 +1,187 @@
+#include "lookup_table.h"  // table layout and API
+#include "conversion.h"    // arithmetic used to fill the table and for misses
+#include <cstdio>          // for std::rename / std::remove
+#include <cstring>         // for std::memcmp / std::memcpy
+#include <fstream>         // for writing the table file
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>     // for open
+#include <sys/mman.h>  // for mmap / munmap
+#include <sys/stat.h>  // for fstat
+#include <unistd.h>    // for close
+#endif
+
+// Currently loaded table (one per process, set up at startup)
+static const unsigned char* mappedBase = nullptr;
+static std::size_t mappedSize = 0;
+static const PackedCalendarEntry* tableEntries = nullptr;
+static long tableFirstJdn = 0;
+static unsigned long tableCount = 0;
+#ifdef _WIN32
+static std::vector<unsigned char> tableBuffer;  // no mmap: the table is read into memory instead
+#endif
+
+// 64-bit FNV-1a
+static std::uint64_t checksumBytes(const unsigned char* data, std::size_t size) {
+    std::uint64_t hash = 1469598103934665603ULL;
+    for (std::size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static bool fitsInt16(int value) {
+    return value >= -32768 && value <= 32767;
+}
+
+bool buildLookupTable(const std::string& path, long firstJdn, long lastJdn) {
+    if (firstJdn < 0 || lastJdn < firstJdn) return false;
+
+    std::size_t count = (std::size_t)(lastJdn - firstJdn + 1);
+    std::vector<PackedCalendarEntry> entries(count);
+    for (std::size_t i = 0; i < count; i++) {
+        ConvertedDate date;
+        convertJDN(firstJdn + (long)i, date);
+        if (!fitsInt16(date.gregorian.year) || !fitsInt16(date.ethiopian.year) || !fitsInt16(date.islamic.year))
+            return false;
+
+        PackedCalendarEntry& e = entries[i];
+        std::memset(&e, 0, sizeof(e));
+        e.gregorianYear = (std::int16_t)date.gregorian.year;
+        e.gregorianMonth = (std::uint8_t)date.gregorian.month;
+        e.gregorianDay = (std::uint8_t)date.gregorian.day;
+        e.ethiopianYear = (std::int16_t)date.ethiopian.year;
+        e.ethiopianMonth = (std::uint8_t)date.ethiopian.month;
+        e.ethiopianDay = (std::uint8_t)date.ethiopian.day;
+        e.islamicYear = (std::int16_t)date.islamic.year;
+        e.islamicMonth = (std::uint8_t)date.islamic.month;
+        e.islamicDay = (std::uint8_t)date.islamic.day;
+        e.ayyaana = (std::uint8_t)date.ayyaana;
+    }
+
+    LookupTableHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, LOOKUP_TABLE_MAGIC, sizeof(header.magic));
+    header.version = LOOKUP_TABLE_VERSION;
+    header.entrySize = sizeof(PackedCalendarEntry);
+    header.firstJdn = firstJdn;
+    header.count = count;
+    header.checksum = checksumBytes(reinterpret_cast<const unsigned char*>(entries.data()),
+                                    count * sizeof(PackedCalendarEntry));
+
+    // Write next to the target and rename so concurrent readers see old or new, never half
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(entries.data()), count * sizeof(PackedCalendarEntry));
+        if (!out) {
+            out.close();
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+    }
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Check header and checksum of a table image; returns false if anything is off
+static bool validateTable(const unsigned char* base, std::size_t size) {
+    if (size < sizeof(LookupTableHeader)) return false;
+    LookupTableHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, LOOKUP_TABLE_MAGIC, sizeof(header.magic)) != 0) return false;
+    if (header.version != LOOKUP_TABLE_VERSION) return false;
+    if (header.entrySize != sizeof(PackedCalendarEntry)) return false;
+    std::size_t payload = size - sizeof(header);
+    if (payload == 0 || payload % sizeof(PackedCalendarEntry) != 0) return false;
+    if (header.count != payload / sizeof(PackedCalendarEntry)) return false;
+    return checksumBytes(base + sizeof(header), payload) == header.checksum;
+}
+
+static void activateTable(const unsigned char* base, std::size_t size) {
+    LookupTableHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    mappedBase = base;
+    mappedSize = size;
+    tableEntries = reinterpret_cast<const PackedCalendarEntry*>(base + sizeof(header));
+    tableFirstJdn = (long)header.firstJdn;
+    tableCount = (unsigned long)header.count;
+}
+
+bool openLookupTable(const std::string& path) {
+    closeLookupTable();
+#ifndef _WIN32
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    std::size_t size = (std::size_t)st.st_size;
+    void* base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);  // the mapping keeps the file alive
+    if (base == MAP_FAILED) return false;
+
+    const unsigned char* bytes = static_cast<const unsigned char*>(base);
+    if (!validateTable(bytes, size)) {
+        munmap(base, size);
+        return false;
+    }
+    activateTable(bytes, size);
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) return false;
+    std::streamsize size = in.tellg();
+    if (size <= 0) return false;
+    tableBuffer.resize((std::size_t)size);
+    in.seekg(0);
+    if (!in.read(reinterpret_cast<char*>(tableBuffer.data()), size) ||
+        !validateTable(tableBuffer.data(), tableBuffer.size())) {
+        tableBuffer.clear();
+        return false;
+    }
+    activateTable(tableBuffer.data(), tableBuffer.size());
+#endif
+    return true;
+}
+
+void closeLookupTable() {
+    if (!mappedBase) return;
+#ifndef _WIN32
+    munmap(const_cast<unsigned char*>(mappedBase), mappedSize);
+#else
+    tableBuffer.clear();
+#endif
+    mappedBase = nullptr;
+    mappedSize = 0;
+    tableEntries = nullptr;
+    tableFirstJdn = 0;
+    tableCount = 0;
+}
+
+bool isLookupTableLoaded() {
+    return tableEntries != nullptr;
+}
+
+void lookupDate(long jdn, ConvertedDate& out) {
+    // Unsigned compare covers both ends of the window in one branch
+    unsigned long index = (unsigned long)(jdn - tableFirstJdn);
+    if (!tableEntries || index >= tableCount) {
+        convertJDN(jdn, out);
+        return;
+    }
+    const PackedCalendarEntry& e = tableEntries[index];
+    out.jdn = jdn;
+    out.gregorian = {e.gregorianDay, e.gregorianMonth, e.gregorianYear};
+    out.ethiopian = {e.ethiopianDay, e.ethiopianMonth, e.ethiopianYear};
+    out.islamic = {e.islamicDay, e.islamicMonth, e.islamicYear};
+    out.ayyaana = e.ayyaana;
+}
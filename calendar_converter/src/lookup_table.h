@@ -0,0 +1,52 @@
+// This file is for the precomputed calendar lookup table
+// it stores every calendar for a fixed JDN window in a binary file that is mmap'd read-only,
+// so a conversion inside the window is a single indexed load shared by all processes
+
+#pragma once  // prevent multiple inclusions
+#include "data.h"
+#include <cstdint>  // for fixed-width integer types
+#include <string>
+
+// Bump LOOKUP_TABLE_VERSION whenever the layout below or the conversion rules change
+const char LOOKUP_TABLE_MAGIC[8] = {'C', 'H', 'R', 'O', 'N', 'L', 'U', 'T'};
+const std::uint32_t LOOKUP_TABLE_VERSION = 3;
+
+// File header, followed by `count` PackedCalendarEntry records for firstJdn, firstJdn + 1, ...
+struct LookupTableHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t entrySize;
+    std::int64_t firstJdn;
+    std::uint64_t count;
+    std::uint64_t checksum;  // FNV-1a over the entry bytes
+};
+
+// One JDN in every calendar, packed into 16 bytes
+struct PackedCalendarEntry {
+    std::int16_t gregorianYear;
+    std::uint8_t gregorianMonth;
+    std::uint8_t gregorianDay;
+    std::int16_t ethiopianYear;
+    std::uint8_t ethiopianMonth;
+    std::uint8_t ethiopianDay;
+    std::int16_t islamicYear;
+    std::uint8_t islamicMonth;
+    std::uint8_t islamicDay;
+    std::uint8_t ayyaana;
+    std::uint8_t reserved[3];
+};
+
+// Build a table covering firstJdn..lastJdn (inclusive) and write it to `path`.
+// The file is written to a temporary name and renamed, so readers never see a partial table.
+// Returns false if the window is empty or negative, a year does not fit in 16 bits, or the write fails.
+bool buildLookupTable(const std::string& path, long firstJdn, long lastJdn);
+
+// Map a table file read-only; validates magic, version, size and checksum.
+// Replaces any table opened earlier. Returns false (and leaves no table loaded) on failure.
+bool openLookupTable(const std::string& path);
+void closeLookupTable();
+bool isLookupTableLoaded();
+
+// Convert a JDN through the table, falling back to the arithmetic in conversion.cpp
+// when no table is loaded or the JDN lies outside its window
+void lookupDate(long jdn, ConvertedDate& out);
@@ -1,8 +1,304 @@
 #include "ui.h"
+#include "bahere_hasab.h"
+#include "conversion.h"  // for the dates of search results
+#include "date_search.h"
+#include "lookup_table.h"
+#include "metrics.h"
+#include "server.h"
+#include "stream_convert.h"
+#include "today.h"
+#include "year_grid.h"
+#include <algorithm>  // for std::max
+#include <cstdio>
+#include <cstdlib>    // for std::atoi / std::strtoull
 #include <iostream>
 #include <locale>
+#include <string>
+#include <thread>     // for hardware_concurrency
+
+// Optional lookup table mode: --lookup-table=PATH maps PATH read-only,
+// building it first for Gregorian 1900-2100 if it does not exist yet
+static void setupLookupTable(const std::string& path) {
+    if (openLookupTable(path)) return;
+    long firstJdn = dateToJDN(1, 1, 1900);
+    long lastJdn = dateToJDN(31, 12, 2100);
+    if (buildLookupTable(path, firstJdn, lastJdn) && openLookupTable(path)) {
+        std::cout << "✓ Lookup table built: " << path << std::endl;
+    } else {
+        std::cout << "⚠️ Could not load lookup table " << path << ", computing dates on the fly." << std::endl;
+    }
+}
+
+// Stream mode: --convert [--from=CAL] [--to=CAL,...] [--repair=MODE] [--extended] [--input=PATH]
+//              [--threads=N] [--timing]
+// converts one date per line from stdin (or PATH) to stdout without the interactive menu;
+// --repair=clamp|roll fixes days past the end of their month instead of rejecting them;
+// --extended accepts years -1,000,000 to 1,000,000 instead of 1-5000;
+// --threads defaults to the core count, --timing prints per-stage times to stderr. See stream_convert.h
+static int runStreamMode(int argc, char* argv[]) {
+    StreamConversionOptions options;
+    options.threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string inputPath;
+    bool showTiming = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool ok = true;
+        if (arg == "--convert") continue;
+        else if (arg.compare(0, 7, "--from=") == 0) ok = parseStreamCalendar(arg.substr(7), options.from);
+        else if (arg.compare(0, 5, "--to=") == 0) ok = parseStreamColumns(arg.substr(5), options.columns);
+        else if (arg.compare(0, 9, "--repair=") == 0) ok = parseStreamRepair(arg.substr(9), options.repair);
+        else if (arg.compare(0, 8, "--input=") == 0) inputPath = arg.substr(8);
+        else if (arg.compare(0, 10, "--threads=") == 0) ok = (options.threads = (unsigned)std::atoi(arg.c_str() + 10)) > 0;
+        else if (arg == "--extended") options.extended = true;
+        else if (arg == "--timing") showTiming = true;
+        else ok = false;
+        if (!ok) {
+            std::fprintf(stderr, "calendar_converter: bad argument '%s'\n"
+                                 "usage: calendar_converter --convert [--from=greg|eth|islamic|julian|coptic] "
+                                 "[--to=greg,eth,islamic,sidama] [--repair=reject|clamp|roll] [--extended] [--input=PATH] [--threads=N] [--timing]\n", argv[i]);
+            return 2;
+        }
+    }
+
+    std::FILE* in = stdin;
+    if (!inputPath.empty() && !(in = std::fopen(inputPath.c_str(), "rb"))) {
+        std::fprintf(stderr, "calendar_converter: cannot open %s\n", inputPath.c_str());
+        return 1;
+    }
+    StreamConversionStats stats;
+    bool ok = runStreamConversion(options, in, stdout, stats);
+    if (in != stdin) std::fclose(in);
+    if (stats.invalid > 0) {
+        std::fprintf(stderr, "calendar_converter: %llu of %llu rows were not valid dates\n", stats.invalid, stats.rows);
+    }
+    if (showTiming) {
+        const StreamStageTimes& t = stats.times;
+        std::fprintf(stderr, "%llu rows in %.3f s with %u thread(s): read %.3f s, parse %.3f s, convert %.3f s, "
+                             "format %.3f s, write %.3f s\n",
+                     stats.rows, t.total, options.threads, t.read, t.parse, t.convert, t.format, t.write);
+    }
+    if (!ok) {
+        std::fprintf(stderr, "calendar_converter: read or write error\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Year grid mode: --year-grid=FIRST[-LAST] [--format=human|csv|json] [--threads=N]
+// writes the full grid of each Ethiopian year to stdout. See year_grid.h
+static int runYearGridMode(int argc, char* argv[]) {
+    int firstYear = 0, lastYear = 0;
+    FormatTemplate format = FORMAT_HUMAN;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool ok = true;
+        if (arg.compare(0, 12, "--year-grid=") == 0) {
+            std::string range = arg.substr(12);
+            std::size_t dash = range.find('-', 1);
+            firstYear = std::atoi(range.c_str());
+            lastYear = dash == std::string::npos ? firstYear : std::atoi(range.c_str() + dash + 1);
+            ok = firstYear >= 1 && lastYear <= 5000 && firstYear <= lastYear;
+        }
+        else if (arg.compare(0, 9, "--format=") == 0) ok = parseFormatTemplate(arg.substr(9), format);
+        else if (arg.compare(0, 10, "--threads=") == 0) ok = (threads = (unsigned)std::atoi(arg.c_str() + 10)) > 0;
+        else ok = false;
+        if (!ok) {
+            std::fprintf(stderr, "calendar_converter: bad argument '%s'\n"
+                                 "usage: calendar_converter --year-grid=FIRST[-LAST] (Ethiopian years 1-5000) "
+                                 "[--format=human|csv|json] [--threads=N]\n", argv[i]);
+            return 2;
+        }
+    }
+    if (!writeYearGrids(firstYear, lastYear, format, threads, stdout)) {
+        std::fprintf(stderr, "calendar_converter: write error\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Feast search: --feast-years=FEAST --on=DAY/MONTH [--calendar=eth|greg] [--years=FIRST-LAST]
+// lists, one per line, the Ethiopian years (1-9999) in which the feast falls on that date. See bahere_hasab.h
+static int runFeastSearchMode(int argc, char* argv[]) {
+    MoveableFeast feast = FEAST_FASIKA;
+    CalendarType calendar = ETHIOPIAN;
+    int day = 0, month = 0;
+    int firstYear = FEAST_INDEX_FIRST_YEAR, lastYear = FEAST_INDEX_LAST_YEAR;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool ok = true;
+        if (arg.compare(0, 14, "--feast-years=") == 0) ok = parseMoveableFeast(arg.substr(14), feast);
+        else if (arg.compare(0, 5, "--on=") == 0) {
+            std::size_t slash = arg.find('/', 5);
+            day = std::atoi(arg.c_str() + 5);
+            month = slash == std::string::npos ? 0 : std::atoi(arg.c_str() + slash + 1);
+            ok = day >= 1 && month >= 1;
+        }
+        else if (arg == "--calendar=eth") calendar = ETHIOPIAN;
+        else if (arg == "--calendar=greg") calendar = GREGORIAN;
+        else if (arg.compare(0, 8, "--years=") == 0) {
+            std::size_t dash = arg.find('-', 9);
+            firstYear = std::atoi(arg.c_str() + 8);
+            lastYear = dash == std::string::npos ? firstYear : std::atoi(arg.c_str() + dash + 1);
+            ok = firstYear <= lastYear;
+        }
+        else ok = false;
+        if (!ok) {
+            std::fprintf(stderr, "calendar_converter: bad argument '%s'\n", argv[i]);
+            month = 0;
+            break;
+        }
+    }
+    if (month == 0) {
+        std::fprintf(stderr, "usage: calendar_converter --feast-years=nineveh|abiy-tsom|debre-zeit|hosanna|siklet|fasika "
+                             "--on=DAY/MONTH [--calendar=eth|greg] [--years=FIRST-LAST]\n");
+        return 2;
+    }
+    for (std::uint16_t year : findFeastYears(feast, calendar, month, day, firstYear, lastYear)) {
+        std::printf("%d\n", (int)year);
+    }
+    return 0;
+}
+
+// Parse "D/M/Y" into a Gregorian JDN (any year of the extended range)
+static bool parseGregorianJDN(const std::string& text, long& jdn) {
+    int day, month, year;
+    if (std::sscanf(text.c_str(), "%d/%d/%d", &day, &month, &year) != 3 || !isValidExtendedDate(day, month, year, GREGORIAN)) {
+        return false;
+    }
+    jdn = (long)extendedToJDN<GregorianCalendar>(day, month, year);
+    return true;
+}
+
+// Date search: --find-dates [--weekday=DAY] [--ayyaana=NAME] [--on=CAL:DAY/MONTH ...] [--from=D/M/Y] [--to=D/M/Y]
+// [--count=N] lists the first N days (default 100) from --from (default today) to --to (default 31/12/9999,
+// both Gregorian) that meet every constraint; a '*' day or month matches any. See date_search.h
+static int runDateSearchMode(int argc, char* argv[]) {
+    DateSearchQuery query;
+    long firstJdn = today().date.jdn;
+    long lastJdn = dateToJDN(31, 12, 9999);
+    unsigned long long count = 100;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool ok = true;
+        if (arg == "--find-dates") continue;
+        else if (arg.compare(0, 10, "--weekday=") == 0) ok = parseWeekday(arg.substr(10), query.weekday);
+        else if (arg.compare(0, 10, "--ayyaana=") == 0) ok = parseAyyaana(arg.substr(10), query.ayyaana);
+        else if (arg.compare(0, 5, "--on=") == 0) {
+            // CAL:DAY/MONTH
+            std::size_t colon = arg.find(':'), slash = arg.find('/');
+            DateConstraint constraint = {GREGORIAN, 0, 0};
+            ok = colon != std::string::npos && slash != std::string::npos && colon < slash &&
+                 parseStreamCalendar(arg.substr(5, colon - 5), constraint.calendar);
+            if (ok) {
+                std::string day = arg.substr(colon + 1, slash - colon - 1), month = arg.substr(slash + 1);
+                constraint.day = day == "*" ? 0 : std::atoi(day.c_str());
+                constraint.month = month == "*" ? 0 : std::atoi(month.c_str());
+                ok = (day == "*" || constraint.day > 0) && (month == "*" || constraint.month > 0);
+                query.dates.push_back(constraint);
+            }
+        }
+        else if (arg.compare(0, 7, "--from=") == 0) ok = parseGregorianJDN(arg.substr(7), firstJdn);
+        else if (arg.compare(0, 5, "--to=") == 0) ok = parseGregorianJDN(arg.substr(5), lastJdn);
+        else if (arg.compare(0, 8, "--count=") == 0) ok = (count = std::strtoull(arg.c_str() + 8, nullptr, 10)) > 0;
+        else ok = false;
+        if (!ok) {
+            std::fprintf(stderr, "calendar_converter: bad argument '%s'\n"
+                                 "usage: calendar_converter --find-dates [--weekday=sun..sat] [--ayyaana=dora|kor|boka|shefero] "
+                                 "[--on=greg|eth|islamic|julian|coptic:DAY/MONTH ...] [--from=D/M/Y] [--to=D/M/Y] [--count=N]\n",
+                         argv[i]);
+            return 2;
+        }
+    }
+
+    // Gregorian, Ethiopian, Hijri, Ayyaana: the columns of stream mode
+    DateSearch search(query, firstJdn, lastJdn);
+    long jdn;
+    for (unsigned long long found = 0; found < count && search.next(jdn); found++) {
+        ConvertedDate date;
+        convertJDN(jdn, date);
+        std::printf("%d/%d/%d,%d/%d/%d,%d/%d/%d,%s\n", date.gregorian.day, date.gregorian.month, date.gregorian.year,
+                    date.ethiopian.day, date.ethiopian.month, date.ethiopian.year, date.islamic.day, date.islamic.month,
+                    date.islamic.year, SIDAMA_AYYAANA[date.ayyaana]);
+    }
+    return 0;
+}
+
+// Server mode: --serve=ADDR [--server-threads=N] answers binary requests until SIGINT/SIGTERM;
+// load generator: --loadgen=ADDR [--connections=N] [--pipeline=N] [--requests=N]. See server.h
+static int runServerMode(int argc, char* argv[], bool loadGenerator) {
+    ServerConfig server;
+    LoadGeneratorConfig load;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool ok = true;
+        if (arg.compare(0, 8, "--serve=") == 0) server.address = arg.substr(8);
+        else if (arg.compare(0, 10, "--loadgen=") == 0) load.address = arg.substr(10);
+        else if (arg.compare(0, 17, "--server-threads=") == 0) ok = (server.threads = (unsigned)std::atoi(arg.c_str() + 17)) > 0;
+        else if (arg.compare(0, 14, "--connections=") == 0) ok = (load.connections = (unsigned)std::atoi(arg.c_str() + 14)) > 0;
+        else if (arg.compare(0, 11, "--pipeline=") == 0) ok = (load.pipeline = (unsigned)std::atoi(arg.c_str() + 11)) > 0;
+        else if (arg.compare(0, 11, "--requests=") == 0) ok = (load.requests = std::strtoull(arg.c_str() + 11, nullptr, 10)) > 0;
+        else ok = false;
+        if (!ok) {
+            std::fprintf(stderr, "calendar_converter: bad argument '%s'\n"
+                                 "usage: calendar_converter --serve=PATH|tcp:PORT [--server-threads=N]\n"
+                                 "       calendar_converter --loadgen=PATH|tcp:PORT [--connections=N] [--pipeline=N] "
+                                 "[--requests=N]\n", argv[i]);
+            return 2;
+        }
+    }
+    if (loadGenerator) return runLoadGenerator(load) ? 0 : 1;
+    return runServer(server) ? 0 : 1;
+}
+
+// Metrics (builds configured with -DCALENDAR_METRICS=ON): --metrics=PATH [--metrics-interval=SECONDS]
+// writes Prometheus text to PATH at exit, on SIGUSR1 and every SECONDS; --metrics-listen=PATH|tcp:PORT
+// serves it to scrapers. Valid in every mode: the flags are taken out of argv before the mode parses it.
+static bool setupMetrics(int& argc, char* argv[]) {
+    MetricsExportConfig config;
+    bool requested = false;
+    int kept = 1;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 10, "--metrics=") == 0) config.file = arg.substr(10);
+        else if (arg.compare(0, 17, "--metrics-listen=") == 0) config.listenAddress = arg.substr(17);
+        else if (arg.compare(0, 19, "--metrics-interval=") == 0) config.intervalSeconds = std::atoi(arg.c_str() + 19);
+        else {
+            argv[kept++] = argv[i];
+            continue;
+        }
+        requested = true;
+    }
+    argc = kept;
+    argv[argc] = nullptr;
+    if (!requested) return true;
+
+    if (!metricsEnabled()) {
+        std::fprintf(stderr, "calendar_converter: built without metrics (configure with -DCALENDAR_METRICS=ON)\n");
+        return false;
+    }
+    if (config.intervalSeconds < 0 || (config.file.empty() && config.listenAddress.empty())) {
+        std::fprintf(stderr, "usage: calendar_converter [--metrics=PATH [--metrics-interval=SECONDS]] "
+                             "[--metrics-listen=PATH|tcp:PORT] ...\n");
+        return false;
+    }
+    return startMetricsExport(config);
+}
+
+int main(int argc, char* argv[]) {
+    if (!setupMetrics(argc, argv)) return 2;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--convert") return runStreamMode(argc, argv);
+        if (arg.compare(0, 12, "--year-grid=") == 0) return runYearGridMode(argc, argv);
+        if (arg.compare(0, 14, "--feast-years=") == 0) return runFeastSearchMode(argc, argv);
+        if (arg == "--find-dates") return runDateSearchMode(argc, argv);
+        if (arg.compare(0, 8, "--serve=") == 0) return runServerMode(argc, argv, false);
+        if (arg.compare(0, 10, "--loadgen=") == 0) return runServerMode(argc, argv, true);
+    }
+
 
-int main() {
     // Set up console for UTF-8
     #ifdef _WIN32
     SetConsoleOutputCP(CP_UTF8);
@@ -11,6 +307,14 @@ int main() {
     
     std::locale::global(std::locale(""));
     std::cout.imbue(std::locale());
+
+    const std::string tableFlag = "--lookup-table=";
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.compare(0, tableFlag.size(), tableFlag) == 0) {
+            setupLookupTable(arg.substr(tableFlag.size()));
+        }
+    }
     
     showWelcome();
     
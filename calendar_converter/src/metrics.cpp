@@ -0,0 +1,400 @@
+#include "metrics.h"  // metrics declarations
+
+#ifdef CALENDAR_METRICS
+#include "server.h"            // for the listening socket
+#include <chrono>              // for the export interval and tick calibration
+#include <cmath>               // for std::ldexp
+#include <condition_variable>  // for waking the export thread
+#include <csignal>             // for SIGUSR1
+#include <cstdarg>             // for appendf
+#include <cstdio>              // for std::vsnprintf / std::fopen / std::rename
+#include <memory>              // for std::unique_ptr
+#include <mutex>
+#include <thread>
+
+#ifdef __linux__
+#include <poll.h>
+#include <pthread.h>           // for pthread_sigmask
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+// Shards
+
+static std::atomic<MetricsShard*> allShards{nullptr};
+
+// Hands the thread's shard back when the thread exits; its totals stay in it for the next owner
+struct MetricsShardRelease {
+    ~MetricsShardRelease() {
+        if (localMetricsShard) localMetricsShard->inUse.store(false, std::memory_order_release);
+        localMetricsShard = nullptr;
+    }
+};
+
+MetricsShard* acquireMetricsShard() {
+    static thread_local MetricsShardRelease release;
+    (void)release;
+
+    MetricsShard* shard = allShards.load(std::memory_order_acquire);
+    for (; shard; shard = shard->next) {
+        bool free = false;
+        if (shard->inUse.compare_exchange_strong(free, true, std::memory_order_acquire)) break;
+    }
+    if (!shard) {
+        // Never freed: the exporter may be reading it, and a later thread will reuse it
+        shard = new MetricsShard();
+        shard->inUse.store(true, std::memory_order_relaxed);
+        MetricsShard* head = allShards.load(std::memory_order_relaxed);
+        do {
+            shard->next = head;
+        } while (!allShards.compare_exchange_weak(head, shard, std::memory_order_release, std::memory_order_relaxed));
+    }
+    localMetricsShard = shard;
+    return shard;
+}
+
+// Ticks per second, measured against steady_clock over the life of the process
+// (only ever read by the exporter, so the calibration costs nothing on the hot paths)
+typedef std::chrono::steady_clock MetricsClock;
+static const MetricsClock::time_point calibrationStart = MetricsClock::now();
+static const std::uint64_t calibrationTicks = metricTicks();
+
+static double ticksPerSecond() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    // Give the measurement at least 50 ms
+    MetricsClock::time_point minimum = calibrationStart + std::chrono::milliseconds(50);
+    if (MetricsClock::now() < minimum) std::this_thread::sleep_until(minimum);
+    double seconds = std::chrono::duration<double>(MetricsClock::now() - calibrationStart).count();
+    return (double)(metricTicks() - calibrationTicks) / seconds;
+#else
+    return 1e9;
+#endif
+}
+
+// Exposition
+
+static const char* const CALENDAR_LABELS[METRIC_CALENDAR_COUNT] = {"", "gregorian", "ethiopian", "islamic",
+                                                                   "julian", "coptic"};
+static const char* const TARGET_LABELS[CONVERSION_TARGET_COUNT] = {"all", "gregorian", "ethiopian", "islamic",
+                                                                   "sidama"};
+
+struct HistogramTotals {
+    std::uint64_t buckets[METRIC_BUCKETS] = {};
+    std::uint64_t sumTicks = 0;
+    std::uint64_t count = 0;
+};
+
+// Every shard's values summed, read with relaxed loads while the owners keep writing
+struct MetricsTotals {
+    std::uint64_t counters[METRIC_COUNTER_COUNT] = {};
+    std::uint64_t conversions[METRIC_CALENDAR_COUNT][CONVERSION_TARGET_COUNT] = {};
+    std::uint64_t invalidDates[METRIC_CALENDAR_COUNT] = {};
+    HistogramTotals conversionLatency[METRIC_CALENDAR_COUNT][CONVERSION_TARGET_COUNT];
+    HistogramTotals histograms[METRIC_HISTOGRAM_COUNT];
+};
+
+static void addHistogram(const MetricHistogramCells& cells, HistogramTotals& totals) {
+    for (int b = 0; b < METRIC_BUCKETS; b++) {
+        std::uint64_t value = cells.buckets[b].load(std::memory_order_relaxed);
+        totals.buckets[b] += value;
+        totals.count += value;
+    }
+    totals.sumTicks += cells.sumTicks.load(std::memory_order_relaxed);
+}
+
+static void sumShards(MetricsTotals& totals) {
+    for (MetricsShard* shard = allShards.load(std::memory_order_acquire); shard; shard = shard->next) {
+        for (int i = 0; i < METRIC_COUNTER_COUNT; i++) totals.counters[i] += shard->counters[i].load(std::memory_order_relaxed);
+        for (int c = 0; c < METRIC_CALENDAR_COUNT; c++) {
+            totals.invalidDates[c] += shard->invalidDates[c].load(std::memory_order_relaxed);
+            for (int t = 0; t < CONVERSION_TARGET_COUNT; t++) {
+                totals.conversions[c][t] += shard->conversions[c][t].load(std::memory_order_relaxed);
+                addHistogram(shard->conversionLatency[c][t], totals.conversionLatency[c][t]);
+            }
+        }
+        for (int h = 0; h < METRIC_HISTOGRAM_COUNT; h++) addHistogram(shard->histograms[h], totals.histograms[h]);
+    }
+}
+
+static void appendf(std::string& out, const char* format, ...) {
+    char line[256];
+    va_list args;
+    va_start(args, format);
+    int length = std::vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (length > 0) out.append(line, (std::size_t)length < sizeof(line) ? (std::size_t)length : sizeof(line) - 1);
+}
+
+static void appendHeader(std::string& out, const char* name, const char* type, const char* help) {
+    appendf(out, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+// Cumulative buckets up to the last non-empty one, then +Inf, _sum and _count.
+// `labels` is empty or a comma-terminated label list.
+static void appendHistogram(std::string& out, const char* name, const std::string& labels,
+                            const HistogramTotals& totals, double secondsPerTick) {
+    int last = METRIC_BUCKETS - 2;
+    while (last > 0 && totals.buckets[last] == 0) last--;
+    std::uint64_t cumulative = 0;
+    for (int b = 0; b <= last; b++) {
+        cumulative += totals.buckets[b];
+        appendf(out, "%s_bucket{%sle=\"%.9g\"} %llu\n", name, labels.c_str(), std::ldexp(1.0, b) * secondsPerTick,
+                (unsigned long long)cumulative);
+    }
+    std::string plain = labels.empty() ? std::string() : "{" + labels.substr(0, labels.size() - 1) + "}";
+    appendf(out, "%s_bucket{%sle=\"+Inf\"} %llu\n", name, labels.c_str(), (unsigned long long)totals.count);
+    appendf(out, "%s_sum%s %.9g\n", name, plain.c_str(), totals.sumTicks * secondsPerTick);
+    appendf(out, "%s_count%s %llu\n", name, plain.c_str(), (unsigned long long)totals.count);
+}
+
+bool metricsEnabled() {
+    return true;
+}
+
+static_assert(METRIC_SAMPLING == 16, "the help texts below say one call in 16");
+
+std::string metricsText() {
+    std::unique_ptr<MetricsTotals> totals(new MetricsTotals());
+    sumShards(*totals);
+    const double secondsPerTick = 1.0 / ticksPerSecond();
+    std::string out;
+    out.reserve(16 * 1024);
+
+    appendHeader(out, "calendar_conversions_total", "counter", "Dates converted, by input calendar and output");
+    for (int c = 1; c < METRIC_CALENDAR_COUNT; c++) {
+        for (int t = 0; t < CONVERSION_TARGET_COUNT; t++) {
+            if (totals->conversions[c][t] == 0) continue;
+            appendf(out, "calendar_conversions_total{from=\"%s\",to=\"%s\"} %llu\n", CALENDAR_LABELS[c], TARGET_LABELS[t],
+                    (unsigned long long)totals->conversions[c][t]);
+        }
+    }
+
+    appendHeader(out, "calendar_conversion_seconds", "histogram",
+                 "Latency of single-date conversions (convert, display, queue the report); one call in 16 is timed");
+    for (int c = 1; c < METRIC_CALENDAR_COUNT; c++) {
+        for (int t = 0; t < CONVERSION_TARGET_COUNT; t++) {
+            if (totals->conversionLatency[c][t].count == 0) continue;
+            std::string labels = std::string("from=\"") + CALENDAR_LABELS[c] + "\",to=\"" + TARGET_LABELS[t] + "\",";
+            appendHistogram(out, "calendar_conversion_seconds", labels, totals->conversionLatency[c][t], secondsPerTick);
+        }
+    }
+
+    appendHeader(out, "calendar_invalid_dates_total", "counter", "Dates rejected as invalid, by input calendar");
+    for (int c = 1; c < METRIC_CALENDAR_COUNT; c++) {
+        appendf(out, "calendar_invalid_dates_total{from=\"%s\"} %llu\n", CALENDAR_LABELS[c],
+                (unsigned long long)totals->invalidDates[c]);
+    }
+
+    static const char* const COUNTERS[METRIC_COUNTER_COUNT][2] = {
+        {"calendar_bahere_hasab_total", "Bahere Hasab computations"},
+        {"calendar_report_writes_total", "Report file appends"},
+        {"calendar_report_records_total", "Report records written"},
+        {"calendar_report_bytes_total", "Report bytes written"},
+    };
+    for (int i = 0; i < METRIC_COUNTER_COUNT; i++) {
+        appendHeader(out, COUNTERS[i][0], "counter", COUNTERS[i][1]);
+        appendf(out, "%s %llu\n", COUNTERS[i][0], (unsigned long long)totals->counters[i]);
+    }
+
+    static const char* const HISTOGRAMS[METRIC_HISTOGRAM_COUNT][2] = {
+        {"calendar_bahere_hasab_display_seconds",
+         "Latency of formatting, displaying and queueing a Bahere Hasab year; one call in 16 is timed"},
+        {"calendar_report_write_seconds", "Latency of one report file append"},
+        {"calendar_server_batch_seconds", "Latency of answering one server batch"},
+        {"calendar_stream_block_seconds", "Latency of converting and formatting one stream mode block"},
+    };
+    for (int h = 0; h < METRIC_HISTOGRAM_COUNT; h++) {
+        appendHeader(out, HISTOGRAMS[h][0], "histogram", HISTOGRAMS[h][1]);
+        appendHistogram(out, HISTOGRAMS[h][0], std::string(), totals->histograms[h], secondsPerTick);
+    }
+    return out;
+}
+
+bool writeMetricsFile(const std::string& path) {
+    std::string text = metricsText();
+    std::string temporary = path + ".tmp";
+    std::FILE* out = std::fopen(temporary.c_str(), "wb");
+    if (!out) return false;
+    bool ok = std::fwrite(text.data(), 1, text.size(), out) == text.size();
+    ok = (std::fclose(out) == 0) && ok;
+#ifdef _WIN32
+    std::remove(path.c_str());  // rename does not replace on Windows
+#endif
+    if (ok) ok = std::rename(temporary.c_str(), path.c_str()) == 0;
+    if (!ok) std::remove(temporary.c_str());
+    return ok;
+}
+
+// Export thread
+
+static volatile std::sig_atomic_t dumpRequested = 0;
+
+#ifndef _WIN32
+static void requestDump(int) {
+    dumpRequested = 1;
+}
+#endif
+
+#ifdef __linux__
+// Answer one scrape: wait briefly for the request (its content does not matter), send the text, close
+static void answerScrape(int fd) {
+    pollfd request = {fd, POLLIN, 0};
+    char discard[4096];
+    if (poll(&request, 1, 200) > 0) {
+        ssize_t ignored = read(fd, discard, sizeof(discard));
+        (void)ignored;
+    }
+    std::string body = metricsText();
+    char header[160];
+    int headerLength = std::snprintf(header, sizeof(header),
+                                     "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\n"
+                                     "Content-Length: %zu\r\n\r\n", body.size());
+    std::string response = std::string(header, (std::size_t)headerLength) + body;
+    for (std::size_t sent = 0; sent < response.size();) {
+        ssize_t n = send(fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) break;
+        sent += (std::size_t)n;
+    }
+    shutdown(fd, SHUT_WR);
+    close(fd);
+}
+#endif
+
+class MetricsExporter {
+public:
+    explicit MetricsExporter(const MetricsExportConfig& config) : config(config) {}
+    ~MetricsExporter();
+
+    bool start();
+
+private:
+    void run();
+    void writeFile();
+
+    MetricsExportConfig config;
+    int listenFd = -1;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    bool stopRequested = false;
+    std::thread thread;
+};
+
+bool MetricsExporter::start() {
+    if (!config.listenAddress.empty()) {
+        listenFd = openServerListener(config.listenAddress);
+        if (listenFd < 0) {
+            std::fprintf(stderr, "calendar_converter: cannot serve metrics on %s\n", config.listenAddress.c_str());
+            return false;
+        }
+    }
+#ifndef _WIN32
+    if (!config.file.empty()) std::signal(SIGUSR1, requestDump);
+#endif
+
+#ifdef __linux__
+    // The thread takes no signals, so SIGINT / SIGTERM still reach the thread that waits for them
+    sigset_t all, previous;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &previous);
+    thread = std::thread(&MetricsExporter::run, this);
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+#else
+    thread = std::thread(&MetricsExporter::run, this);
+#endif
+    return true;
+}
+
+MetricsExporter::~MetricsExporter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopRequested = true;
+    }
+    wakeup.notify_one();
+    if (thread.joinable()) thread.join();
+    if (listenFd >= 0) closeServerListener(listenFd, config.listenAddress);
+    writeFile();  // the final totals
+}
+
+void MetricsExporter::writeFile() {
+    if (config.file.empty()) return;
+    if (!writeMetricsFile(config.file)) {
+        std::fprintf(stderr, "calendar_converter: cannot write metrics to %s\n", config.file.c_str());
+    }
+}
+
+void MetricsExporter::run() {
+    // Wakes every 100 ms at most to notice SIGUSR1
+    const auto tick = std::chrono::milliseconds(100);
+    const auto interval = std::chrono::seconds(config.intervalSeconds);
+    MetricsClock::time_point nextWrite = MetricsClock::now() + interval;
+
+    while (true) {
+#ifdef __linux__
+        if (listenFd >= 0) {
+            pollfd listener = {listenFd, POLLIN, 0};
+            if (poll(&listener, 1, (int)tick.count()) > 0) {
+                int fd;
+                while ((fd = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC)) >= 0) answerScrape(fd);
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopRequested) return;
+        } else
+#endif
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (wakeup.wait_for(lock, tick, [&] { return stopRequested; })) return;
+        }
+
+        bool due = config.intervalSeconds > 0 && MetricsClock::now() >= nextWrite;
+        if (dumpRequested || due) {
+            dumpRequested = 0;
+            writeFile();
+            if (due) nextWrite = MetricsClock::now() + interval;
+        }
+    }
+}
+
+static std::mutex exporterMutex;
+static std::unique_ptr<MetricsExporter> exporterInstance;
+
+// Stops the export thread and writes the final file at exit
+struct MetricsExportShutdown {
+    ~MetricsExportShutdown() { stopMetricsExport(); }
+};
+static MetricsExportShutdown shutdownAtExit;
+
+bool startMetricsExport(const MetricsExportConfig& config) {
+    std::lock_guard<std::mutex> lock(exporterMutex);
+    if (exporterInstance) return true;
+    std::unique_ptr<MetricsExporter> exporter(new MetricsExporter(config));
+    if (!exporter->start()) return false;
+    exporterInstance = std::move(exporter);
+    return true;
+}
+
+void stopMetricsExport() {
+    std::lock_guard<std::mutex> lock(exporterMutex);
+    exporterInstance.reset();
+}
+
+#else  // !CALENDAR_METRICS
+
+bool metricsEnabled() {
+    return false;
+}
+
+std::string metricsText() {
+    return std::string();
+}
+
+bool writeMetricsFile(const std::string&) {
+    return false;
+}
+
+bool startMetricsExport(const MetricsExportConfig&) {
+    return false;
+}
+
+void stopMetricsExport() {}
+
+#endif
@@ -0,0 +1,192 @@
+// This file is for the engine metrics
+// hot paths bump per-thread counters and log2-bucketed latency histograms (no locks, no shared
+// cache lines); an exporter sums the threads on demand into the Prometheus text format, written
+// to a file (periodically, on SIGUSR1 and at exit) or served over a socket.
+// Built only with the CALENDAR_METRICS CMake option: otherwise every call below is an empty
+// inline function and MetricTimer an empty object, so instrumented code compiles to what it was.
+
+#pragma once  // prevent multiple inclusions
+#include "data.h"   // for CalendarType
+#include <atomic>
+#include <cstdint>  // for fixed-width integer types
+#include <string>
+
+#ifdef CALENDAR_METRICS
+#if defined(_MSC_VER)
+#include <intrin.h>     // for __rdtsc
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>  // for __rdtsc
+#else
+#include <chrono>       // timer ticks are nanoseconds where there is no TSC
+#endif
+#endif
+
+// What a conversion produced: every calendar, or one output column (stream mode)
+enum ConversionTarget {
+    TO_ALL_CALENDARS,
+    TO_GREGORIAN,
+    TO_ETHIOPIAN,
+    TO_ISLAMIC,
+    TO_SIDAMA,
+    CONVERSION_TARGET_COUNT
+};
+
+const int METRIC_CALENDAR_COUNT = COPTIC + 1;  // indexed by CalendarType (0 unused)
+
+enum MetricCounter {
+    METRIC_BAHERE_HASAB,   // years served: Bahere Hasab display, server requests, year grids
+    METRIC_REPORT_WRITES,  // report file appends (one per batch)
+    METRIC_REPORT_RECORDS, // records in those appends
+    METRIC_REPORT_BYTES,
+    METRIC_COUNTER_COUNT
+};
+
+// Latency histograms besides the per-pair conversion ones.
+// Operations much cheaper than a microsecond are only counted; the two clock reads of a timing
+// cost about 50 ns, so operations of about a microsecond are timed one call in METRIC_SAMPLING.
+enum MetricHistogram {
+    METRIC_BAHERE_HASAB_DISPLAY,  // displayBahereHasabResults
+    METRIC_REPORT_WRITE,          // one report file append
+    METRIC_SERVER_BATCH,          // one server batch (answerBatch)
+    METRIC_STREAM_BLOCK,          // one stream mode block (convertBlock)
+    METRIC_HISTOGRAM_COUNT
+};
+
+// Bucket b counts timings below 2^b ticks; the last bucket takes everything longer
+const int METRIC_BUCKETS = 48;
+
+const std::uint32_t METRIC_SAMPLING = 16;
+
+// Calls per timed call: single-date conversions and the Bahere Hasab display are sampled
+constexpr std::uint32_t metricSampling(MetricHistogram histogram) {
+    return histogram == METRIC_BAHERE_HASAB_DISPLAY ? METRIC_SAMPLING : 1;
+}
+
+struct MetricHistogramCells {
+    std::atomic<std::uint64_t> buckets[METRIC_BUCKETS];
+    std::atomic<std::uint64_t> sumTicks;
+    std::uint32_t countdown;  // calls left until the next sampled one (owner thread only)
+};
+
+// One thread's metrics. Only the owning thread writes them (so plain load + store, no locked
+// instructions); the exporter reads them concurrently. Shards of finished threads are reused.
+struct alignas(64) MetricsShard {
+    std::atomic<std::uint64_t> counters[METRIC_COUNTER_COUNT];
+    std::atomic<std::uint64_t> conversions[METRIC_CALENDAR_COUNT][CONVERSION_TARGET_COUNT];
+    std::atomic<std::uint64_t> invalidDates[METRIC_CALENDAR_COUNT];
+    MetricHistogramCells conversionLatency[METRIC_CALENDAR_COUNT][CONVERSION_TARGET_COUNT];
+    MetricHistogramCells histograms[METRIC_HISTOGRAM_COUNT];
+    std::atomic<bool> inUse;
+    MetricsShard* next;  // every shard ever created, newest first
+};
+
+struct MetricsExportConfig {
+    std::string file;           // Prometheus text file, replaced atomically; empty for none
+    int intervalSeconds = 0;    // also rewrite `file` this often (0: only on SIGUSR1 and at exit)
+    std::string listenAddress;  // serve the text to every connection (as HTTP): a Unix socket path
+                                // or "tcp:PORT", as for --serve; Linux only; empty for none
+};
+
+#ifdef CALENDAR_METRICS
+
+// Constant-initialized and defined here, so reading it is a plain thread-local load
+inline thread_local MetricsShard* localMetricsShard = nullptr;
+MetricsShard* acquireMetricsShard();  // first use on a thread
+
+inline MetricsShard& metricsShard() {
+    MetricsShard* shard = localMetricsShard;
+    return shard ? *shard : *acquireMetricsShard();
+}
+
+inline void bumpMetric(std::atomic<std::uint64_t>& cell, std::uint64_t amount) {
+    cell.store(cell.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+inline std::uint64_t metricTicks() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// The bit width of `ticks`, so bucket b holds 2^(b-1) .. 2^b - 1
+inline int metricBucket(std::uint64_t ticks) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    int width = _BitScanReverse64(&index, ticks) ? (int)index + 1 : 0;
+#else
+    int width = ticks != 0 ? 64 - __builtin_clzll(ticks) : 0;
+#endif
+    return width < METRIC_BUCKETS ? width : METRIC_BUCKETS - 1;
+}
+
+inline void observeTicks(MetricHistogramCells& histogram, std::uint64_t ticks) {
+    bumpMetric(histogram.buckets[metricBucket(ticks)], 1);
+    bumpMetric(histogram.sumTicks, ticks);
+}
+
+inline void countMetric(MetricCounter counter, std::uint64_t amount = 1) {
+    bumpMetric(metricsShard().counters[counter], amount);
+}
+
+inline void countConversions(CalendarType from, ConversionTarget to, std::uint64_t amount = 1) {
+    bumpMetric(metricsShard().conversions[from][to], amount);
+}
+
+inline void countInvalidDates(CalendarType from, std::uint64_t amount = 1) {
+    bumpMetric(metricsShard().invalidDates[from], amount);
+}
+
+// Times its own lifetime into a histogram (when the call is sampled, see metricSampling)
+class MetricTimer {
+public:
+    explicit MetricTimer(MetricHistogram histogram) {
+        begin(metricsShard().histograms[histogram], metricSampling(histogram));
+    }
+    MetricTimer(CalendarType from, ConversionTarget to) { begin(metricsShard().conversionLatency[from][to], METRIC_SAMPLING); }
+    ~MetricTimer() {
+        if (cells) observeTicks(*cells, metricTicks() - start);
+    }
+    MetricTimer(const MetricTimer&) = delete;
+    MetricTimer& operator=(const MetricTimer&) = delete;
+
+private:
+    void begin(MetricHistogramCells& histogram, std::uint32_t sampling) {
+        if (sampling > 1 && histogram.countdown-- != 0) return;
+        histogram.countdown = sampling - 1;
+        cells = &histogram;
+        start = metricTicks();
+    }
+
+    MetricHistogramCells* cells = nullptr;
+    std::uint64_t start = 0;
+};
+
+#else  // !CALENDAR_METRICS
+
+inline void countMetric(MetricCounter, std::uint64_t = 1) {}
+inline void countConversions(CalendarType, ConversionTarget, std::uint64_t = 1) {}
+inline void countInvalidDates(CalendarType, std::uint64_t = 1) {}
+
+class MetricTimer {
+public:
+    explicit MetricTimer(MetricHistogram) {}
+    MetricTimer(CalendarType, ConversionTarget) {}
+};
+
+#endif
+
+// True when built with CALENDAR_METRICS; without it the functions below do nothing and return false
+bool metricsEnabled();
+
+// Every metric summed over all threads, in the Prometheus text exposition format
+std::string metricsText();
+
+// Write metricsText() to `path` (through a temporary file and a rename)
+bool writeMetricsFile(const std::string& path);
+
+// Start the export thread (see MetricsExportConfig); the file is written a last time at exit
+bool startMetricsExport(const MetricsExportConfig& config);
+void stopMetricsExport();
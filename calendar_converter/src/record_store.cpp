@@ -0,0 +1,573 @@
+#include "record_store.h"  // store layout and API
+#include "calendar_core.h"  // to place records on the JDN index
+#include <algorithm>        // for std::sort
+#include <climits>          // for INT_MIN / INT_MAX
+#include <cstdio>           // for the journal file
+#include <cstring>          // for std::memcmp / std::memcpy
+#include <iostream>         // for showAllRecords
+#include <new>              // for std::nothrow
+#include <set>              // for the ordered JDN index
+#include <utility>          // for std::pair
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>        // for _chsize_s / _commit
+#else
+#include <fcntl.h>     // for open
+#include <sys/mman.h>  // for mmap / munmap
+#include <sys/stat.h>  // for fstat
+#include <unistd.h>    // for pread / pwrite / fsync
+#endif
+
+static_assert(sizeof(StoredRecord) == 32, "StoredRecord is part of the file format");
+
+const std::size_t SEGMENT_BYTES = RECORDS_PER_SEGMENT * (sizeof(StoredRecord) + sizeof(std::uint32_t));
+static_assert(SEGMENT_BYTES % 4096 == 0 && RECORD_STORE_HEADER_BYTES % 4096 == 0,
+              "segments must stay page aligned in the file");
+
+// Changes between automatic checkpoints
+const std::uint32_t CHECKPOINT_INTERVAL = 65536;
+
+// One journaled change: the new contents of a slot, the id it belongs to, and the counters after
+// the change. Replaying an entry overwrites state instead of adjusting it, so replaying a journal
+// over a store that already holds some of its changes gives the same result.
+struct JournalEntry {
+    std::uint32_t slot;
+    std::int32_t id;
+    StoredRecord image;
+    RecordStoreState state;
+    std::uint64_t checksum;  // FNV-1a over the fields above
+};
+
+// A segment is mmap'd (POSIX) or heap memory (Windows); it is dirty while it differs from the file
+struct Segment {
+    unsigned char* base;
+    bool fileBacked;  // part of the private mapping of the store file
+    bool dirty;
+};
+
+static std::vector<Segment> segments;
+static RecordStoreState state = {0, 0, 0, 1};
+
+// Ordered (jdn, id) index, built on the first range query so opening a store stays cheap
+static std::set<std::pair<long, int>> jdnIndex;
+static bool jdnIndexBuilt = false;
+
+// Open store, if any; the record functions open RECORD_STORE_FILE on first use unless
+// openRecordStore has already been called
+static bool storeOpen = false;
+static bool storeRequested = false;
+#ifdef _WIN32
+static std::FILE* storeFile = nullptr;
+#else
+static int storeFd = -1;
+#endif
+static std::FILE* journal = nullptr;
+static long journalBytes = 0;
+static std::uint32_t journalEntries = 0;
+static bool syncWrites = false;
+
+// 64-bit FNV-1a
+static std::uint64_t checksumBytes(const unsigned char* data, std::size_t size) {
+    std::uint64_t hash = 1469598103934665603ULL;
+    for (std::size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static std::uint64_t entryChecksum(const JournalEntry& entry) {
+    return checksumBytes(reinterpret_cast<const unsigned char*>(&entry), offsetof(JournalEntry, checksum));
+}
+
+static StoredRecord* segmentSlots(std::size_t index) {
+    return reinterpret_cast<StoredRecord*>(segments[index].base);
+}
+
+static std::uint32_t* segmentIds(std::size_t index) {
+    return reinterpret_cast<std::uint32_t*>(segments[index].base + RECORDS_PER_SEGMENT * sizeof(StoredRecord));
+}
+
+static StoredRecord& slotAt(std::uint32_t slot) {
+    return segmentSlots(slot / RECORDS_PER_SEGMENT)[slot % RECORDS_PER_SEGMENT];
+}
+
+static std::uint32_t& idEntry(int id) {
+    std::uint32_t index = (std::uint32_t)(id - 1);
+    return segmentIds(index / RECORDS_PER_SEGMENT)[index % RECORDS_PER_SEGMENT];
+}
+
+// Platform file helpers for the store file
+
+static bool writeStoreAt(std::uint64_t offset, const void* data, std::size_t size) {
+#ifdef _WIN32
+    return _fseeki64(storeFile, (long long)offset, SEEK_SET) == 0 && std::fwrite(data, 1, size, storeFile) == size;
+#else
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    while (size > 0) {
+        ssize_t n = pwrite(storeFd, bytes, size, (off_t)offset);
+        if (n <= 0) return false;
+        bytes += n;
+        offset += (std::uint64_t)n;
+        size -= (std::size_t)n;
+    }
+    return true;
+#endif
+}
+
+static bool syncStoreFile() {
+#ifdef _WIN32
+    return std::fflush(storeFile) == 0 && _commit(_fileno(storeFile)) == 0;
+#else
+    return fsync(storeFd) == 0;
+#endif
+}
+
+static bool syncJournal() {
+    if (std::fflush(journal) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(journal)) == 0;
+#else
+    return fsync(fileno(journal)) == 0;
+#endif
+}
+
+static bool truncateJournal(long size) {
+    std::fflush(journal);
+#ifdef _WIN32
+    return _chsize_s(_fileno(journal), size) == 0;
+#else
+    return ftruncate(fileno(journal), size) == 0;
+#endif
+}
+
+// Segment memory: new segments start zero-filled (empty) and dirty
+
+static unsigned char* allocateSegment() {
+#ifdef _WIN32
+    return new (std::nothrow) unsigned char[SEGMENT_BYTES]();
+#else
+    void* base = mmap(nullptr, SEGMENT_BYTES, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return base == MAP_FAILED ? nullptr : static_cast<unsigned char*>(base);
+#endif
+}
+
+static void releaseSegments() {
+    for (const Segment& segment : segments) {
+#ifdef _WIN32
+        delete[] segment.base;
+#else
+        munmap(segment.base, SEGMENT_BYTES);
+#endif
+    }
+    segments.clear();
+}
+
+static bool ensureSegment(std::size_t index) {
+    while (segments.size() <= index) {
+        unsigned char* base = allocateSegment();
+        if (!base) return false;
+        segments.push_back({base, false, true});
+    }
+    return true;
+}
+
+// Only records with a known calendar and a valid date are stored, so every stored record has a JDN
+static bool isStorableRecord(const CalendarRecord& record) {
+    return isKnownCalendar(record.calendarType) &&
+           isValidCalendarDate(record.day, record.month, record.year, record.calendarType);
+}
+
+static long recordJDN(const CalendarRecord& record) {
+    return calendarToJDN(record.calendarType, record.day, record.month, record.year);
+}
+
+// Change application
+
+static void applyChange(const JournalEntry& entry) {
+    StoredRecord& target = slotAt(entry.slot);
+    if (jdnIndexBuilt) {
+        if (target.live) jdnIndex.erase({target.jdn, target.record.id});
+        if (entry.image.live) jdnIndex.insert({entry.image.jdn, entry.id});
+    }
+    target = entry.image;
+    idEntry(entry.id) = entry.image.live ? entry.slot + 1 : 0;
+    segments[entry.slot / RECORDS_PER_SEGMENT].dirty = true;
+    segments[(std::uint32_t)(entry.id - 1) / RECORDS_PER_SEGMENT].dirty = true;
+    state = entry.state;
+}
+
+// Journal the change (when a store is open), then apply it in memory
+static bool commitChange(std::uint32_t slot, int id, const StoredRecord& image, const RecordStoreState& next) {
+    // Allocate first so that a journaled change can always be applied
+    if (!ensureSegment(slot / RECORDS_PER_SEGMENT) || !ensureSegment((std::uint32_t)(id - 1) / RECORDS_PER_SEGMENT))
+        return false;
+
+    JournalEntry entry;
+    std::memset(&entry, 0, sizeof(entry));
+    entry.slot = slot;
+    entry.id = id;
+    entry.image = image;
+    entry.state = next;
+    entry.checksum = entryChecksum(entry);
+
+    if (journal) {
+        bool ok = std::fwrite(&entry, sizeof(entry), 1, journal) == 1 && std::fflush(journal) == 0;
+        if (ok && syncWrites) ok = syncJournal();
+        if (!ok) {
+            truncateJournal(journalBytes);  // never leave a partial entry in front of later ones
+            return false;
+        }
+        journalBytes += (long)sizeof(entry);
+        journalEntries++;
+    }
+
+    applyChange(entry);
+    if (journal && journalEntries >= CHECKPOINT_INTERVAL) checkpointRecordStore();
+    return true;
+}
+
+static bool slotOfId(int id, std::uint32_t& slot) {
+    if (id < 1 || id >= state.nextId) return false;
+    if ((std::uint32_t)(id - 1) / RECORDS_PER_SEGMENT >= segments.size()) return false;
+    std::uint32_t entry = idEntry(id);
+    if (entry == 0) return false;
+    slot = entry - 1;
+    return true;
+}
+
+// Opens the default store the first time any record function runs, so a program that never
+// touches records never creates the files
+static void useRecordStore() {
+    if (storeRequested) return;
+    if (!openRecordStore()) {
+        std::cerr << "⚠️ Could not open " << RECORD_STORE_FILE << ", records will not be saved." << std::endl;
+    }
+}
+
+// Record functions declared in data.h
+
+int addRecord(const CalendarRecord& record) {
+    useRecordStore();
+    if (state.nextId == INT_MAX || !isStorableRecord(record)) return 0;
+
+    RecordStoreState next = state;
+    std::uint32_t slot;
+    if (state.freeHead != 0) {
+        slot = state.freeHead - 1;
+        next.freeHead = slotAt(slot).nextFree;
+    } else {
+        slot = next.slotCount++;
+    }
+    int id = next.nextId++;
+    next.recordCount++;
+
+    StoredRecord image;
+    std::memset(&image, 0, sizeof(image));
+    image.record = record;
+    image.record.id = id;
+    image.jdn = (std::int32_t)recordJDN(record);
+    image.live = 1;
+    return commitChange(slot, id, image, next) ? id : 0;
+}
+
+bool updateRecord(int id, const CalendarRecord& record) {
+    useRecordStore();
+    std::uint32_t slot;
+    if (!isStorableRecord(record) || !slotOfId(id, slot)) return false;
+
+    StoredRecord image = slotAt(slot);
+    image.record = record;
+    image.record.id = id;
+    image.jdn = (std::int32_t)recordJDN(record);
+    return commitChange(slot, id, image, state);
+}
+
+bool deleteRecord(int id) {
+    useRecordStore();
+    std::uint32_t slot;
+    if (!slotOfId(id, slot)) return false;
+
+    RecordStoreState next = state;
+    next.freeHead = slot + 1;
+    next.recordCount--;
+
+    StoredRecord image;
+    std::memset(&image, 0, sizeof(image));
+    image.nextFree = state.freeHead;
+    return commitChange(slot, id, image, next);
+}
+
+const CalendarRecord* findRecord(int id) {
+    useRecordStore();
+    std::uint32_t slot;
+    if (!slotOfId(id, slot)) return nullptr;
+    return &slotAt(slot).record;
+}
+
+void showAllRecords() {
+    static const char* CALENDAR_NAMES[] = {"", "Gregorian", "Ethiopian", "Islamic", "Julian", "Coptic"};
+    useRecordStore();
+    if (state.recordCount == 0) {
+        std::cout << "No records saved." << std::endl;
+        return;
+    }
+    for (std::uint32_t slot = 0; slot < state.slotCount; slot++) {
+        const StoredRecord& entry = slotAt(slot);
+        if (!entry.live) continue;
+        CalendarType type = entry.record.calendarType;
+        const char* calendar = isKnownCalendar(type) ? CALENDAR_NAMES[type] : "Unknown";
+        std::cout << "#" << entry.record.id << "  " << entry.record.day << "/" << entry.record.month << "/"
+                  << entry.record.year << "  (" << calendar << ")\n";
+    }
+    std::cout.flush();
+}
+
+int getRecordCount() {
+    useRecordStore();
+    return state.recordCount;
+}
+
+// Collects the live records in id order and counting-sorts them by JDN (stable, so ties stay in id
+// order); valid dates span under two million days, so this is much cheaper than a comparison sort
+static void buildJdnIndex() {
+    std::vector<std::pair<long, int>> entries;
+    entries.reserve((std::size_t)state.recordCount);
+    long minJdn = 0;
+    long maxJdn = -1;
+    for (int id = 1; id < state.nextId; id++) {
+        std::uint32_t slot;
+        if (!slotOfId(id, slot)) continue;
+        long jdn = slotAt(slot).jdn;
+        if (entries.empty() || jdn < minJdn) minJdn = jdn;
+        if (entries.empty() || jdn > maxJdn) maxJdn = jdn;
+        entries.push_back({jdn, id});
+    }
+
+    // Records outside the supported years can stretch the span; fall back to a comparison sort then
+    if (maxJdn - minJdn > 4 * (long)entries.size() + (1L << 22)) {
+        std::sort(entries.begin(), entries.end());
+    } else if (!entries.empty()) {
+        std::vector<std::pair<long, int>> sorted(entries.size());
+        std::vector<std::uint32_t> offsets((std::size_t)(maxJdn - minJdn + 2), 0);
+        for (const auto& entry : entries) offsets[entry.first - minJdn + 1]++;
+        for (std::size_t i = 1; i < offsets.size(); i++) offsets[i] += offsets[i - 1];
+        for (const auto& entry : entries) sorted[offsets[entry.first - minJdn]++] = entry;
+        entries.swap(sorted);
+    }
+
+    jdnIndex = std::set<std::pair<long, int>>(entries.begin(), entries.end());  // linear for sorted input
+    jdnIndexBuilt = true;
+}
+
+std::vector<CalendarRecord> findRecordsInRange(long firstJdn, long lastJdn) {
+    useRecordStore();
+    if (!jdnIndexBuilt) buildJdnIndex();
+    std::vector<CalendarRecord> matches;
+    auto it = jdnIndex.lower_bound({firstJdn, INT_MIN});
+    for (; it != jdnIndex.end() && it->first <= lastJdn; ++it) {
+        matches.push_back(*findRecord(it->second));
+    }
+    return matches;
+}
+
+// Store lifecycle
+
+static void resetMemory() {
+    releaseSegments();
+    state = {0, 0, 0, 1};
+    jdnIndex.clear();
+    jdnIndexBuilt = false;
+}
+
+static void closeStoreFiles() {
+    if (journal) std::fclose(journal);
+    journal = nullptr;
+#ifdef _WIN32
+    if (storeFile) std::fclose(storeFile);
+    storeFile = nullptr;
+#else
+    if (storeFd >= 0) close(storeFd);
+    storeFd = -1;
+#endif
+    storeOpen = false;
+}
+
+static bool writeHeader() {
+    unsigned char page[RECORD_STORE_HEADER_BYTES];
+    std::memset(page, 0, sizeof(page));
+    RecordStoreHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, RECORD_STORE_MAGIC, sizeof(header.magic));
+    header.version = RECORD_STORE_VERSION;
+    header.slotSize = sizeof(StoredRecord);
+    header.recordsPerSegment = RECORDS_PER_SEGMENT;
+    header.state = state;
+    std::memcpy(page, &header, sizeof(header));
+    return writeStoreAt(0, page, sizeof(page));
+}
+
+// Map the segments already in the file. Only whole segments count: a segment cut short by a crash
+// during a checkpoint is rebuilt from the journal, which is not emptied until the checkpoint completes.
+static bool loadSegments(std::uint64_t fileSize) {
+    std::size_t count = fileSize > RECORD_STORE_HEADER_BYTES
+                            ? (std::size_t)((fileSize - RECORD_STORE_HEADER_BYTES) / SEGMENT_BYTES) : 0;
+    if (count == 0) return true;
+#ifdef _WIN32
+    for (std::size_t k = 0; k < count; k++) {
+        unsigned char* base = new (std::nothrow) unsigned char[SEGMENT_BYTES];
+        if (!base) return false;
+        segments.push_back({base, true, false});
+        if (_fseeki64(storeFile, (long long)(RECORD_STORE_HEADER_BYTES + k * SEGMENT_BYTES), SEEK_SET) != 0 ||
+            std::fread(base, 1, SEGMENT_BYTES, storeFile) != SEGMENT_BYTES)
+            return false;
+    }
+#else
+    // One private mapping for the whole file: pages fault in on first touch, and writes stay in
+    // this process until a checkpoint copies them back
+    void* base = mmap(nullptr, count * SEGMENT_BYTES, PROT_READ | PROT_WRITE, MAP_PRIVATE, storeFd,
+                      (off_t)RECORD_STORE_HEADER_BYTES);
+    if (base == MAP_FAILED) return false;
+    for (std::size_t k = 0; k < count; k++) {
+        segments.push_back({static_cast<unsigned char*>(base) + k * SEGMENT_BYTES, true, false});
+    }
+#endif
+    return true;
+}
+
+// Apply the valid prefix of the journal and cut off anything after it
+static bool replayJournal(const std::string& journalPath, std::uint32_t& replayed) {
+    replayed = 0;
+    long validBytes = 0;
+    if (std::FILE* in = std::fopen(journalPath.c_str(), "rb")) {
+        JournalEntry entry;
+        while (std::fread(&entry, sizeof(entry), 1, in) == 1 && entry.checksum == entryChecksum(entry) &&
+               entry.id >= 1) {
+            if (!ensureSegment(entry.slot / RECORDS_PER_SEGMENT) ||
+                !ensureSegment((std::uint32_t)(entry.id - 1) / RECORDS_PER_SEGMENT)) {
+                std::fclose(in);
+                return false;
+            }
+            applyChange(entry);
+            validBytes += (long)sizeof(entry);
+            replayed++;
+        }
+        std::fclose(in);
+    }
+
+    journal = std::fopen(journalPath.c_str(), "ab");
+    if (!journal) return false;
+    journalBytes = validBytes;
+    journalEntries = replayed;
+    return truncateJournal(validBytes);
+}
+
+// Delete (through the journal) the live records a damaged file or an older build left with an unknown
+// calendar or an invalid date; returns how many were dropped
+static std::uint32_t dropUnstorableRecords() {
+    std::uint32_t dropped = 0;
+    for (std::uint32_t slot = 0; slot < state.slotCount && slot / RECORDS_PER_SEGMENT < segments.size(); slot++) {
+        const StoredRecord& entry = slotAt(slot);
+        std::uint32_t idSlot;
+        if (!entry.live || isStorableRecord(entry.record)) continue;
+        if (slotOfId(entry.record.id, idSlot) && idSlot == slot && deleteRecord(entry.record.id)) dropped++;
+    }
+    return dropped;
+}
+
+bool openRecordStore(const std::string& path, bool syncEveryWrite) {
+    closeRecordStore();
+    storeRequested = true;
+    syncWrites = syncEveryWrite;
+
+    std::uint64_t fileSize = 0;
+#ifdef _WIN32
+    storeFile = std::fopen(path.c_str(), "r+b");
+    if (!storeFile) storeFile = std::fopen(path.c_str(), "w+b");
+    if (!storeFile) return false;
+    _fseeki64(storeFile, 0, SEEK_END);
+    fileSize = (std::uint64_t)_ftelli64(storeFile);
+    _fseeki64(storeFile, 0, SEEK_SET);
+#else
+    storeFd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (storeFd < 0) return false;
+    struct stat st;
+    if (fstat(storeFd, &st) != 0) {
+        closeStoreFiles();
+        return false;
+    }
+    fileSize = (std::uint64_t)st.st_size;
+#endif
+
+    bool ok = true;
+    if (fileSize < sizeof(RecordStoreHeader)) {
+        // New store (or one whose creation was interrupted): start from an empty header
+        ok = writeHeader() && syncStoreFile();
+        fileSize = RECORD_STORE_HEADER_BYTES;
+    } else {
+        RecordStoreHeader header;
+#ifdef _WIN32
+        ok = std::fread(&header, sizeof(header), 1, storeFile) == 1;
+#else
+        ok = pread(storeFd, &header, sizeof(header), 0) == (ssize_t)sizeof(header);
+#endif
+        ok = ok && std::memcmp(header.magic, RECORD_STORE_MAGIC, sizeof(header.magic)) == 0 &&
+             header.version == RECORD_STORE_VERSION && header.slotSize == sizeof(StoredRecord) &&
+             header.recordsPerSegment == RECORDS_PER_SEGMENT;
+        if (ok) state = header.state;
+    }
+
+    std::uint32_t replayed = 0;
+    ok = ok && loadSegments(fileSize) && replayJournal(path + ".wal", replayed);
+    if (!ok) {
+        closeStoreFiles();
+        resetMemory();
+        return false;
+    }
+    storeOpen = true;
+    std::uint32_t dropped = dropUnstorableRecords();
+    if (replayed > 0 || dropped > 0) checkpointRecordStore();
+    return true;
+}
+
+bool checkpointRecordStore() {
+    if (!storeOpen) return false;
+
+    // The journal must be durable before the file holds any change it describes
+    if (!syncJournal()) return false;
+    for (std::size_t k = 0; k < segments.size(); k++) {
+        if (segments[k].dirty &&
+            !writeStoreAt(RECORD_STORE_HEADER_BYTES + k * SEGMENT_BYTES, segments[k].base, SEGMENT_BYTES))
+            return false;
+    }
+    if (!syncStoreFile() || !writeHeader() || !syncStoreFile()) return false;
+
+    // The file is now complete; until this truncation a crash replays the journal again, which is harmless
+    if (!truncateJournal(0)) return false;
+    journalBytes = 0;
+    journalEntries = 0;
+
+    for (std::size_t k = 0; k < segments.size(); k++) {
+        if (!segments[k].dirty) continue;
+#ifndef _WIN32
+        // Drop the private copies of a mapped segment: its pages now read back from the file
+        // (page cache) at the same address. New segments stay anonymous until the store is reopened.
+        if (segments[k].fileBacked) madvise(segments[k].base, SEGMENT_BYTES, MADV_DONTNEED);
+#endif
+        segments[k].dirty = false;
+    }
+    return true;
+}
+
+void closeRecordStore() {
+    if (storeOpen) checkpointRecordStore();
+    closeStoreFiles();
+    resetMemory();
+}
+
+// Checkpoints the store when the program exits
+struct RecordStoreShutdown {
+    ~RecordStoreShutdown() { closeRecordStore(); }
+};
+static RecordStoreShutdown shutdownAtExit;
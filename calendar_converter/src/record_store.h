@@ -0,0 +1,63 @@
+// This file is for the persistent record store
+// records live in fixed-size segments of records.db, mapped copy-on-write so the file only changes
+// at a checkpoint; every change is first appended to a journal (records.db.wal), and a checkpoint
+// copies the changed segments back. Reopening the store is an mmap plus a replay of the journal.
+// The record functions in data.h open RECORD_STORE_FILE on first use (and keep working on memory
+// only, after a warning on stderr, if it cannot be opened); call openRecordStore first for another path.
+
+#pragma once  // prevent multiple inclusions
+#include "data.h"
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for fixed-width integer types
+#include <string>
+
+const char* const RECORD_STORE_FILE = "records.db";
+
+// Bump RECORD_STORE_VERSION whenever the layout below changes
+const char RECORD_STORE_MAGIC[8] = {'C', 'H', 'R', 'O', 'N', 'R', 'E', 'C'};
+const std::uint32_t RECORD_STORE_VERSION = 1;
+
+const std::uint32_t RECORDS_PER_SEGMENT = 4096;
+const std::size_t RECORD_STORE_HEADER_BYTES = 4096;  // the header page; segments follow it
+
+// Store-wide counters; slot numbers are stored as slot + 1 so that 0 means "none"
+struct RecordStoreState {
+    std::uint32_t slotCount;  // slots handed out so far (live or free)
+    std::uint32_t freeHead;   // first free slot + 1
+    std::int32_t recordCount;
+    std::int32_t nextId;
+};
+
+// Start of the header page (the rest of the page is zero)
+struct RecordStoreHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t slotSize;
+    std::uint32_t recordsPerSegment;
+    std::uint32_t reserved;
+    RecordStoreState state;  // as of the last checkpoint
+};
+
+// One record slot, 32 bytes. A segment is RECORDS_PER_SEGMENT slots followed by RECORDS_PER_SEGMENT
+// id entries (slot + 1 of the record with that id), so a zero-filled segment is empty.
+struct StoredRecord {
+    CalendarRecord record;
+    std::int32_t jdn;
+    std::uint32_t nextFree;  // next free slot + 1 while the slot is unused
+    std::uint32_t live;
+};
+
+// Open (or create) the store at `path` and replace the records in memory with its contents.
+// A journal left by a crash is replayed; a torn last entry is discarded. Records with an unknown
+// calendar or an invalid date (a damaged file) are deleted, as addRecord/updateRecord reject them.
+// syncEveryWrite makes each change durable (fsync) before it returns; otherwise changes survive a
+// process crash but a power loss can lose the changes since the last checkpoint.
+bool openRecordStore(const std::string& path = RECORD_STORE_FILE, bool syncEveryWrite = false);
+
+// Write the changed segments to the store file and empty the journal.
+// Also done automatically every 65,536 changes and when the store is closed.
+bool checkpointRecordStore();
+
+// Checkpoint and close the store; the records in memory are cleared and later record calls work on
+// memory only (also done automatically at exit)
+void closeRecordStore();
@@ -0,0 +1,277 @@
+#include "report_writer.h"  // background report writer declarations
+#include "metrics.h"          // report write counters and latency
+#include "today.h"            // for the record timestamps
+#include <atomic>             // for the lock-free queue and counters
+#include <chrono>             // for flush intervals
+#include <condition_variable> // for waking the writer and flush waiters
+#include <cstdio>             // for std::fopen / std::fwrite
+#include <ctime>              // for timestamps
+#include <memory>             // for std::unique_ptr
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static const char* REPORT_FILE_NAMES[REPORT_FILE_COUNT] = {"report.txt", "holidays_report.txt"};
+
+// One queued record. `sequence` implements the bounded MPSC ring (Vyukov's design):
+// a slot is free for the producer claiming position p when sequence == p,
+// and holds a record for the consumer when sequence == p + 1.
+struct ReportSlot {
+    std::atomic<std::size_t> sequence;
+    ReportFile file;
+    std::time_t timestamp;
+    std::string content;
+};
+
+class ReportWriter {
+public:
+    explicit ReportWriter(const ReportWriterConfig& config);
+    ~ReportWriter();
+
+    bool submit(ReportFile file, std::string&& content);
+    void flush();
+    ReportWriterStats stats() const;
+
+private:
+    bool tryPush(ReportFile file, std::time_t timestamp, std::string& content, std::size_t& pos);
+    bool tryPop(ReportFile& file, std::time_t& timestamp, std::string& content);
+    void wakeWriter();
+    void run();
+
+    ReportWriterConfig config;
+    std::vector<ReportSlot> slots;
+    std::size_t mask;
+    std::atomic<std::size_t> enqueuePos{0};
+    std::size_t dequeuePos = 0;  // writer thread only
+
+    std::atomic<unsigned long long> queued{0};
+    std::atomic<unsigned long long> written{0};
+    std::atomic<unsigned long long> dropped{0};
+    std::atomic<unsigned long long> processed{0};  // written + lost to file errors
+
+    std::mutex mutex;                 // only for sleeping/waking, never on the submit fast path
+    std::condition_variable wakeup;   // writer sleeps here
+    std::condition_variable flushed;  // flush() callers sleep here
+    std::atomic<bool> drainRequested{false};
+    std::atomic<bool> flushRequested{false};
+    std::atomic<bool> stopRequested{false};
+    std::thread thread;
+};
+
+ReportWriter::ReportWriter(const ReportWriterConfig& cfg) : config(cfg) {
+    std::size_t capacity = 2;
+    while (capacity < config.queueCapacity) capacity <<= 1;
+    slots = std::vector<ReportSlot>(capacity);
+    for (std::size_t i = 0; i < capacity; i++) slots[i].sequence.store(i, std::memory_order_relaxed);
+    mask = capacity - 1;
+    thread = std::thread(&ReportWriter::run, this);
+}
+
+ReportWriter::~ReportWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopRequested.store(true, std::memory_order_release);
+    }
+    wakeup.notify_one();
+    thread.join();
+}
+
+bool ReportWriter::tryPush(ReportFile file, std::time_t timestamp, std::string& content, std::size_t& pos) {
+    pos = enqueuePos.load(std::memory_order_relaxed);
+    ReportSlot* slot;
+    while (true) {
+        slot = &slots[pos & mask];
+        std::size_t seq = slot->sequence.load(std::memory_order_acquire);
+        long diff = (long)seq - (long)pos;
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            return false;  // full
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    slot->file = file;
+    slot->timestamp = timestamp;
+    slot->content.swap(content);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool ReportWriter::tryPop(ReportFile& file, std::time_t& timestamp, std::string& content) {
+    ReportSlot& slot = slots[dequeuePos & mask];
+    if (slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1) return false;  // empty
+    file = slot.file;
+    timestamp = slot.timestamp;
+    content.swap(slot.content);
+    slot.content.clear();
+    slot.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+    dequeuePos++;
+    return true;
+}
+
+void ReportWriter::wakeWriter() {
+    std::lock_guard<std::mutex> lock(mutex);
+    drainRequested.store(true, std::memory_order_release);
+    wakeup.notify_one();
+}
+
+bool ReportWriter::submit(ReportFile file, std::string&& content) {
+    std::time_t now = std::time(nullptr);
+    std::size_t pos;
+    while (!tryPush(file, now, content, pos)) {
+        wakeWriter();  // the queue is full: make sure the writer is draining it
+        if (config.policy == DROP_WHEN_FULL) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    queued.fetch_add(1, std::memory_order_release);
+    // Every quarter of the ring, nudge the writer so a burst never finds the queue full
+    if ((pos & (mask >> 2)) == 0) wakeWriter();
+    return true;
+}
+
+void ReportWriter::flush() {
+    unsigned long long target = queued.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(mutex);
+    flushRequested.store(true, std::memory_order_release);
+    wakeup.notify_one();
+    flushed.wait(lock, [&] { return processed.load(std::memory_order_acquire) >= target; });
+}
+
+ReportWriterStats ReportWriter::stats() const {
+    return {queued.load(std::memory_order_relaxed), written.load(std::memory_order_relaxed),
+            dropped.load(std::memory_order_relaxed)};
+}
+
+// "[YYYY-MM-DD HH:MM:SS]"
+static void appendTimestamp(std::time_t timestamp, std::string& out) {
+    char text[LOCAL_TIMESTAMP_BYTES];
+    formatLocalTimestamp(timestamp, text);
+    out += '[';
+    out += text;
+    out += ']';
+}
+
+void ReportWriter::run() {
+    using Clock = std::chrono::steady_clock;
+    const auto interval = std::chrono::milliseconds(config.flushIntervalMs);
+
+    std::string buffers[REPORT_FILE_COUNT];
+    unsigned long long pending[REPORT_FILE_COUNT] = {};
+    Clock::time_point oldest[REPORT_FILE_COUNT];
+    std::string content;
+
+    while (true) {
+        bool stopping = stopRequested.load(std::memory_order_acquire);
+        bool flushing = flushRequested.exchange(false, std::memory_order_acq_rel);
+
+        // Drain everything queued so far into the per-file buffers
+        ReportFile file;
+        std::time_t timestamp;
+        std::size_t drained = 0;
+        while (tryPop(file, timestamp, content)) {
+            if (pending[file] == 0) oldest[file] = Clock::now();
+            appendTimestamp(timestamp, buffers[file]);
+            buffers[file] += '\n';
+            buffers[file] += content;
+            buffers[file] += "\n\n";
+            pending[file]++;
+            drained++;
+        }
+
+        // One open-append-close per file per batch (the UI may delete the files in between)
+        bool wrote = false;
+        Clock::time_point now = Clock::now();
+        for (int f = 0; f < REPORT_FILE_COUNT; f++) {
+            if (pending[f] == 0) continue;
+            if (!stopping && !flushing && buffers[f].size() < config.batchBytes && now - oldest[f] < interval) continue;
+
+            bool ok;
+            {
+                MetricTimer timer(METRIC_REPORT_WRITE);
+                std::FILE* out = std::fopen(REPORT_FILE_NAMES[f], "a");
+                ok = out && std::fwrite(buffers[f].data(), 1, buffers[f].size(), out) == buffers[f].size();
+                if (out) ok = (std::fclose(out) == 0) && ok;
+            }
+            countMetric(METRIC_REPORT_WRITES);
+            if (ok) {
+                countMetric(METRIC_REPORT_RECORDS, pending[f]);
+                countMetric(METRIC_REPORT_BYTES, buffers[f].size());
+            }
+            if (ok) written.fetch_add(pending[f], std::memory_order_relaxed);
+            else dropped.fetch_add(pending[f], std::memory_order_relaxed);
+            processed.fetch_add(pending[f], std::memory_order_release);
+            buffers[f].clear();
+            pending[f] = 0;
+            wrote = true;
+        }
+
+        if (wrote || flushing) {
+            std::lock_guard<std::mutex> lock(mutex);
+            flushed.notify_all();
+        }
+        if (stopping && drained == 0) break;
+
+        if (drained == 0) {
+            // Sleep until the oldest buffered record is due, or a full interval if nothing is buffered
+            Clock::time_point deadline = now + interval;
+            for (int f = 0; f < REPORT_FILE_COUNT; f++) {
+                if (pending[f] != 0 && oldest[f] + interval < deadline) deadline = oldest[f] + interval;
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeup.wait_until(lock, deadline, [&] {
+                return stopRequested.load(std::memory_order_acquire) || flushRequested.load(std::memory_order_acquire) ||
+                       drainRequested.load(std::memory_order_acquire);
+            });
+            drainRequested.store(false, std::memory_order_relaxed);
+        }
+    }
+}
+
+// The process-wide writer. Producers read `activeWriter` without locking;
+// start/stop are serialized by `lifecycleMutex` and must not race with submitReport.
+static std::mutex lifecycleMutex;
+static std::unique_ptr<ReportWriter> writerInstance;
+static std::atomic<ReportWriter*> activeWriter{nullptr};
+
+// Drains and joins the writer when the program exits
+struct ReportWriterShutdown {
+    ~ReportWriterShutdown() { stopReportWriter(); }
+};
+static ReportWriterShutdown shutdownAtExit;
+
+void startReportWriter(const ReportWriterConfig& config) {
+    std::lock_guard<std::mutex> lock(lifecycleMutex);
+    if (writerInstance) return;
+    writerInstance.reset(new ReportWriter(config));
+    activeWriter.store(writerInstance.get(), std::memory_order_release);
+}
+
+void stopReportWriter() {
+    std::lock_guard<std::mutex> lock(lifecycleMutex);
+    activeWriter.store(nullptr, std::memory_order_release);
+    writerInstance.reset();
+}
+
+bool submitReport(ReportFile file, std::string content) {
+    ReportWriter* writer = activeWriter.load(std::memory_order_acquire);
+    if (!writer) {
+        startReportWriter();
+        writer = activeWriter.load(std::memory_order_acquire);
+    }
+    return writer->submit(file, std::move(content));
+}
+
+void flushReports() {
+    ReportWriter* writer = activeWriter.load(std::memory_order_acquire);
+    if (writer) writer->flush();
+}
+
+ReportWriterStats getReportWriterStats() {
+    ReportWriter* writer = activeWriter.load(std::memory_order_acquire);
+    if (!writer) return {0, 0, 0};
+    return writer->stats();
+}
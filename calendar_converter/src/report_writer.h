@@ -0,0 +1,49 @@
+// This file is for the background report writer
+// conversions hand their report text to a lock-free queue and return immediately;
+// a single writer thread timestamps the records and appends them to the report files in batches
+
+#pragma once  // prevent multiple inclusions
+#include <cstddef>  // for std::size_t
+#include <string>
+
+// Report files the writer appends to
+enum ReportFile {
+    CONVERSION_REPORT,  // report.txt
+    HOLIDAYS_REPORT,    // holidays_report.txt
+    REPORT_FILE_COUNT
+};
+
+// What submitReport does when the queue is full
+enum OverflowPolicy {
+    BLOCK_WHEN_FULL,  // wait for the writer to make room
+    DROP_WHEN_FULL    // discard the record and count it as dropped
+};
+
+struct ReportWriterConfig {
+    std::size_t queueCapacity = 4096;    // records; rounded up to a power of two
+    std::size_t batchBytes = 64 * 1024;  // write a file's buffer once it reaches this size
+    int flushIntervalMs = 200;           // ...or once it has waited this long
+    OverflowPolicy policy = BLOCK_WHEN_FULL;
+};
+
+struct ReportWriterStats {
+    unsigned long long queued;   // accepted by submitReport
+    unsigned long long written;  // appended to a report file
+    unsigned long long dropped;  // queue full under DROP_WHEN_FULL, or lost to a failed file write
+};
+
+// Start the writer thread. Optional: submitReport starts it with the default config on first use.
+// Has no effect if the writer is already running.
+void startReportWriter(const ReportWriterConfig& config = ReportWriterConfig());
+
+// Write everything still queued and stop the writer thread (also done automatically at exit)
+void stopReportWriter();
+
+// Queue a record for `file`; the "[YYYY-MM-DD HH:MM:SS]" header is taken from the submit time.
+// Returns false if the record was dropped.
+bool submitReport(ReportFile file, std::string content);
+
+// Block until every record submitted before this call has been written
+void flushReports();
+
+ReportWriterStats getReportWriterStats();
@@ -0,0 +1,635 @@
+#include "server.h"  // server and load generator declarations
+#include <cstdio>    // for error messages
+
+#ifdef __linux__
+#include "bahere_hasab.h"  // for Bahere Hasab requests
+#include "batch.h"         // batch kernels for conversion requests
+#include "metrics.h"       // request counters and batch latency
+#include <algorithm>       // for std::sort
+#include <atomic>
+#include <cerrno>
+#include <chrono>          // for latency measurement
+#include <csignal>         // for SIGINT / SIGTERM
+#include <cstdlib>         // for std::atoi
+#include <cstring>         // for std::memcpy / std::memset
+#include <memory>          // for std::unique_ptr
+#include <mutex>
+#include <random>          // for the load generator's request mix
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <arpa/inet.h>     // for htons / htonl
+#include <fcntl.h>         // for O_NONBLOCK
+#include <netinet/in.h>    // for sockaddr_in
+#include <netinet/tcp.h>   // for TCP_NODELAY
+#include <pthread.h>       // for pthread_sigmask
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>      // for S_ISSOCK
+#include <sys/un.h>        // for sockaddr_un
+#include <unistd.h>
+
+static_assert(sizeof(ServerRequest) == 12, "ServerRequest is part of the wire format");
+static_assert(sizeof(ServerResponse) == 40, "ServerResponse is part of the wire format");
+
+const std::size_t SERVER_READ_BYTES = 64 * 1024;          // read per connection per wake-up
+const std::size_t SERVER_MAX_BACKLOG = 1024 * 1024;       // stop reading a client this far behind
+const int SERVER_MAX_EVENTS = 256;
+
+// Socket helpers
+
+static bool isTcpAddress(const std::string& address) {
+    return address.compare(0, 4, "tcp:") == 0;
+}
+
+// Fill `storage` for `address`; returns the address length, or 0 if it is malformed
+static socklen_t resolveAddress(const std::string& address, sockaddr_storage& storage) {
+    std::memset(&storage, 0, sizeof(storage));
+    if (isTcpAddress(address)) {
+        int port = std::atoi(address.c_str() + 4);
+        if (port <= 0 || port > 65535) return 0;
+        sockaddr_in* in = reinterpret_cast<sockaddr_in*>(&storage);
+        in->sin_family = AF_INET;
+        in->sin_port = htons((std::uint16_t)port);
+        in->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        return sizeof(sockaddr_in);
+    }
+    sockaddr_un* un = reinterpret_cast<sockaddr_un*>(&storage);
+    if (address.empty() || address.size() >= sizeof(un->sun_path)) return 0;
+    un->sun_family = AF_UNIX;
+    std::memcpy(un->sun_path, address.c_str(), address.size() + 1);
+    return sizeof(sockaddr_un);
+}
+
+static void setNoDelay(int fd, const std::string& address) {
+    if (!isTcpAddress(address)) return;
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+}
+
+// Request processing
+
+static long dateToJDNFor(const ServerRequest& request) {
+    return calendarToJDN((CalendarType)request.calendar, request.day, request.month, request.year);
+}
+
+static ServerDate packDate(const CalendarDate& date) {
+    return {(std::int16_t)date.year, (std::uint8_t)date.month, (std::uint8_t)date.day};
+}
+
+// Scratch space for one batch, reused across wake-ups
+struct RequestBatch {
+    std::vector<ServerRequest> requests;
+    std::vector<ServerResponse> responses;
+    std::vector<long> jdns;                // conversion requests only
+    std::vector<std::size_t> conversions;  // their positions in `requests`
+    std::vector<int> columns[10];          // Gregorian, Ethiopian, Islamic d/m/y, then Ayyaana
+};
+
+static void answerBatch(RequestBatch& batch) {
+    MetricTimer timer(METRIC_SERVER_BATCH);
+    std::size_t count = batch.requests.size();
+    batch.responses.resize(count);
+    batch.jdns.clear();
+    batch.conversions.clear();
+
+    for (std::size_t i = 0; i < count; i++) {
+        const ServerRequest& request = batch.requests[i];
+        ServerResponse& response = batch.responses[i];
+        std::memset(&response, 0, sizeof(response));
+        response.tag = request.tag;
+        response.op = request.op;
+
+        if (request.op == SERVER_CONVERT) {
+            if (!isKnownCalendar((CalendarType)request.calendar)) {
+                response.status = SERVER_BAD_REQUEST;
+            } else if (!isValidCalendarDate(request.day, request.month, request.year, (CalendarType)request.calendar)) {
+                response.status = SERVER_INVALID_DATE;
+                countInvalidDates((CalendarType)request.calendar);
+            } else {
+                countConversions((CalendarType)request.calendar, TO_ALL_CALENDARS);
+                batch.jdns.push_back(dateToJDNFor(request));
+                batch.conversions.push_back(i);
+            }
+        } else if (request.op == SERVER_BAHERE_HASAB) {
+            if (request.year < 1 || request.year > 5000) {
+                response.status = SERVER_INVALID_DATE;
+                continue;
+            }
+            countMetric(METRIC_BAHERE_HASAB);
+            BahereHasabValues values = computeBahereHasab(request.year);
+            MoveableFeasts feasts = feastsForYear(request.year);
+            response.value = values.ameteAlem;
+            response.wenber = (std::uint8_t)values.wenber;
+            response.abekte = (std::uint8_t)values.abekte;
+            response.metqi = (std::uint8_t)values.metqi;
+            response.wengelawi = (std::uint8_t)values.wengelawiIndex;
+            for (int f = 0; f < FEAST_COUNT; f++) response.dates[f] = packDate(feasts.dates[f]);
+        } else {
+            response.status = SERVER_BAD_REQUEST;
+        }
+    }
+
+    // Every conversion in the batch goes through the kernels in one call
+    std::size_t conversions = batch.jdns.size();
+    if (conversions == 0) return;
+    for (std::vector<int>& column : batch.columns) column.resize(conversions);
+    std::vector<int>* c = batch.columns;
+    convertJDNBatch(batch.jdns.data(), conversions,
+                    {{c[0].data(), c[1].data(), c[2].data()},
+                     {c[3].data(), c[4].data(), c[5].data()},
+                     {c[6].data(), c[7].data(), c[8].data()},
+                     c[9].data()});
+    for (std::size_t k = 0; k < conversions; k++) {
+        ServerResponse& response = batch.responses[batch.conversions[k]];
+        response.value = (std::int32_t)batch.jdns[k];
+        response.ayyaana = (std::uint8_t)c[9][k];
+        for (int calendar = 0; calendar < 3; calendar++) {
+            response.dates[calendar] = packDate({c[3 * calendar][k], c[3 * calendar + 1][k], c[3 * calendar + 2][k]});
+        }
+    }
+}
+
+// Event loops
+
+struct Connection {
+    int fd;
+    std::vector<char> input = std::vector<char>(SERVER_READ_BYTES);
+    std::size_t inputUsed = 0;
+    std::vector<char> output;
+    std::size_t outputSent = 0;
+    std::uint32_t events = 0;  // current epoll interest
+    bool closing = false;
+    bool touched = false;      // has responses from the current batch
+};
+
+// Tags for the epoll entries that are not connections
+static char LISTENER_TAG;
+static char WAKE_TAG;
+
+class EventLoop {
+public:
+    EventLoop(const std::string& address, int listenFd) : address(address), listenFd(listenFd) {}
+    ~EventLoop();
+
+    bool init();
+    void run(std::vector<std::unique_ptr<EventLoop>>& loops);
+    void adopt(int fd);  // hand over an accepted connection (any thread)
+    void stop();         // any thread
+
+private:
+    void acceptConnections(std::vector<std::unique_ptr<EventLoop>>& loops);
+    void addConnection(int fd);
+    void readRequests(Connection& connection);
+    void sendResponses(Connection& connection);
+    void updateInterest(Connection& connection);
+
+    std::string address;
+    int listenFd;
+    int epollFd = -1;
+    int wakeFd = -1;
+    std::size_t nextLoop = 0;
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;
+    RequestBatch batch;
+    std::vector<Connection*> batchOwners;  // connection of each request in `batch`
+
+    std::mutex handoffMutex;
+    std::vector<int> handoff;
+    std::atomic<bool> stopping{false};
+};
+
+EventLoop::~EventLoop() {
+    for (auto& entry : connections) close(entry.first);
+    if (epollFd >= 0) close(epollFd);
+    if (wakeFd >= 0) close(wakeFd);
+}
+
+bool EventLoop::init() {
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || wakeFd < 0) return false;
+
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = &WAKE_TAG;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event) != 0) return false;
+    if (listenFd >= 0) {
+        event.data.ptr = &LISTENER_TAG;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event) != 0) return false;
+    }
+    return true;
+}
+
+void EventLoop::adopt(int fd) {
+    {
+        std::lock_guard<std::mutex> lock(handoffMutex);
+        handoff.push_back(fd);
+    }
+    std::uint64_t one = 1;
+    if (write(wakeFd, &one, sizeof(one)) < 0) {}  // the counter cannot overflow in practice
+}
+
+void EventLoop::stop() {
+    stopping.store(true, std::memory_order_release);
+    std::uint64_t one = 1;
+    if (write(wakeFd, &one, sizeof(one)) < 0) {}
+}
+
+void EventLoop::addConnection(int fd) {
+    std::unique_ptr<Connection> connection(new Connection);
+    connection->fd = fd;
+    connection->events = EPOLLIN;
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = connection.get();
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        close(fd);
+        return;
+    }
+    connections[fd] = std::move(connection);
+}
+
+// Spread new connections over the loops round-robin
+void EventLoop::acceptConnections(std::vector<std::unique_ptr<EventLoop>>& loops) {
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;  // EAGAIN, or an error the next wake-up will report again
+        setNoDelay(fd, address);
+        EventLoop* target = loops[nextLoop++ % loops.size()].get();
+        if (target == this) addConnection(fd);
+        else target->adopt(fd);
+    }
+}
+
+// One read per wake-up (epoll is level-triggered, so the rest is reported again);
+// complete requests join the batch
+void EventLoop::readRequests(Connection& connection) {
+    ssize_t got = recv(connection.fd, connection.input.data() + connection.inputUsed,
+                       connection.input.size() - connection.inputUsed, 0);
+    if (got <= 0) {
+        if (got == 0 || (errno != EAGAIN && errno != EINTR)) connection.closing = true;
+        return;
+    }
+    connection.inputUsed += (std::size_t)got;
+
+    std::size_t complete = connection.inputUsed / sizeof(ServerRequest);
+    std::size_t first = batch.requests.size();
+    batch.requests.resize(first + complete);
+    std::memcpy(&batch.requests[first], connection.input.data(), complete * sizeof(ServerRequest));
+    batchOwners.insert(batchOwners.end(), complete, &connection);
+
+    std::size_t consumed = complete * sizeof(ServerRequest);
+    std::memmove(connection.input.data(), connection.input.data() + consumed, connection.inputUsed - consumed);
+    connection.inputUsed -= consumed;
+}
+
+void EventLoop::sendResponses(Connection& connection) {
+    while (connection.outputSent < connection.output.size()) {
+        ssize_t sent = send(connection.fd, connection.output.data() + connection.outputSent,
+                            connection.output.size() - connection.outputSent, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN) connection.closing = true;
+            break;
+        }
+        connection.outputSent += (std::size_t)sent;
+    }
+    if (connection.outputSent == connection.output.size()) {
+        connection.output.clear();
+        connection.outputSent = 0;
+    }
+    updateInterest(connection);
+}
+
+// Wait for writability while responses are pending; stop reading from a client that does not read
+void EventLoop::updateInterest(Connection& connection) {
+    std::size_t backlog = connection.output.size() - connection.outputSent;
+    std::uint32_t events =
+        (backlog < SERVER_MAX_BACKLOG ? (std::uint32_t)EPOLLIN : 0u) | (backlog > 0 ? (std::uint32_t)EPOLLOUT : 0u);
+    if (events == connection.events || connection.closing) return;
+    epoll_event event;
+    event.events = events;
+    event.data.ptr = &connection;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+    connection.events = events;
+}
+
+void EventLoop::run(std::vector<std::unique_ptr<EventLoop>>& loops) {
+    epoll_event events[SERVER_MAX_EVENTS];
+    std::vector<Connection*> touched;
+
+    while (!stopping.load(std::memory_order_acquire)) {
+        int ready = epoll_wait(epollFd, events, SERVER_MAX_EVENTS, -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        batch.requests.clear();
+        batchOwners.clear();
+        for (int i = 0; i < ready; i++) {
+            void* tag = events[i].data.ptr;
+            if (tag == &LISTENER_TAG) {
+                acceptConnections(loops);
+            } else if (tag == &WAKE_TAG) {
+                std::uint64_t count;
+                if (read(wakeFd, &count, sizeof(count)) < 0) {}
+                std::vector<int> adopted;
+                {
+                    std::lock_guard<std::mutex> lock(handoffMutex);
+                    adopted.swap(handoff);
+                }
+                for (int fd : adopted) addConnection(fd);
+            } else {
+                Connection& connection = *static_cast<Connection*>(tag);
+                if (events[i].events & EPOLLOUT) sendResponses(connection);
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) readRequests(connection);
+            }
+        }
+
+        // Everything that arrived in this wake-up is answered as one batch
+        if (!batch.requests.empty()) {
+            answerBatch(batch);
+            touched.clear();
+            for (std::size_t i = 0; i < batch.responses.size(); i++) {
+                Connection& connection = *batchOwners[i];
+                const char* bytes = reinterpret_cast<const char*>(&batch.responses[i]);
+                connection.output.insert(connection.output.end(), bytes, bytes + sizeof(ServerResponse));
+                if (!connection.touched) {
+                    connection.touched = true;
+                    touched.push_back(&connection);
+                }
+            }
+            for (Connection* connection : touched) {
+                connection->touched = false;
+                sendResponses(*connection);
+            }
+        }
+
+        // Close connections only now, so no pointer in this batch dangles
+        for (auto it = connections.begin(); it != connections.end();) {
+            if (it->second->closing) {
+                close(it->first);
+                it = connections.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+int openServerListener(const std::string& address) {
+    sockaddr_storage storage;
+    socklen_t length = resolveAddress(address, storage);
+    if (length == 0) return -1;
+
+    int fd = socket(storage.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (isTcpAddress(address)) {
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    } else {
+        // Replace a socket file left behind by an earlier run, but never another kind of file
+        struct stat st;
+        if (stat(address.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) unlink(address.c_str());
+    }
+    if (bind(fd, reinterpret_cast<sockaddr*>(&storage), length) != 0 || listen(fd, SOMAXCONN) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void closeServerListener(int fd, const std::string& address) {
+    close(fd);
+    if (!isTcpAddress(address)) unlink(address.c_str());
+}
+
+bool runServer(const ServerConfig& config) {
+    // Block the stop signals in every thread; this thread collects them with sigwait
+    sigset_t stopSignals, previousMask;
+    sigemptyset(&stopSignals);
+    sigaddset(&stopSignals, SIGINT);
+    sigaddset(&stopSignals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stopSignals, &previousMask);
+
+    int listenFd = openServerListener(config.address);
+    if (listenFd < 0) {
+        std::fprintf(stderr, "calendar_converter: cannot listen on %s\n", config.address.c_str());
+        pthread_sigmask(SIG_SETMASK, &previousMask, nullptr);
+        return false;
+    }
+
+    unsigned threads = config.threads > 0 ? config.threads : 1;
+    std::vector<std::unique_ptr<EventLoop>> loops;
+    bool ok = true;
+    for (unsigned i = 0; i < threads && ok; i++) {
+        loops.emplace_back(new EventLoop(config.address, i == 0 ? listenFd : -1));
+        ok = loops.back()->init();
+    }
+
+    if (ok) {
+        std::vector<std::thread> workers;
+        for (auto& loop : loops) workers.emplace_back(&EventLoop::run, loop.get(), std::ref(loops));
+        std::fprintf(stderr, "calendar_converter: serving on %s with %u event loop(s)\n", config.address.c_str(), threads);
+
+        int signal;
+        sigwait(&stopSignals, &signal);
+        for (auto& loop : loops) loop->stop();
+        for (std::thread& worker : workers) worker.join();
+    }
+
+    loops.clear();
+    closeServerListener(listenFd, config.address);
+    pthread_sigmask(SIG_SETMASK, &previousMask, nullptr);
+    return ok;
+}
+
+// Load generator
+//
+// One thread drives every connection through epoll, keeping `pipeline` requests in flight on each.
+// A request's tag is its slot (connection * pipeline + index), which records when it was sent.
+
+typedef std::chrono::steady_clock LoadClock;
+
+struct LoadConnection {
+    int fd;
+    std::vector<char> input = std::vector<char>(64 * 1024);
+    std::size_t inputUsed = 0;
+    std::vector<char> output;
+};
+
+static std::vector<ServerRequest> makeRequestMix(unsigned bahereHasabPercent) {
+    std::mt19937 random(20240907);
+    std::vector<ServerRequest> mix(4096);
+    for (ServerRequest& request : mix) {
+        std::memset(&request, 0, sizeof(request));
+        if (random() % 100 < bahereHasabPercent) {
+            request.op = SERVER_BAHERE_HASAB;
+            request.year = 1900 + (int)(random() % 200);
+        } else {
+            request.op = SERVER_CONVERT;
+            request.calendar = (std::uint8_t)(GREGORIAN + random() % 3);
+            request.day = (std::uint8_t)(1 + random() % 28);
+            request.month = (std::uint8_t)(1 + random() % 12);
+            request.year = request.calendar == ISLAMIC ? 1300 + (int)(random() % 200) : 1900 + (int)(random() % 200);
+        }
+    }
+    return mix;
+}
+
+// The response a correct server gives, used to check every answer
+static bool checkResponse(const ServerRequest& request, const ServerResponse& response) {
+    if (response.status != SERVER_OK || response.op != request.op) return false;
+    if (request.op == SERVER_BAHERE_HASAB) {
+        MoveableFeasts feasts = computeMoveableFeasts(request.year);
+        return response.value == request.year + AMETE_ALEM_OFFSET && response.dates[FEAST_FASIKA].day ==
+               feasts.dates[FEAST_FASIKA].day && response.dates[FEAST_FASIKA].month == feasts.dates[FEAST_FASIKA].month;
+    }
+    long jdn = dateToJDNFor(request);
+    CalendarDate gregorian = gregorianFromJDN(jdn);
+    return response.value == jdn && response.dates[0].day == gregorian.day && response.dates[0].year == gregorian.year;
+}
+
+bool runLoadGenerator(const LoadGeneratorConfig& config) {
+    sockaddr_storage storage;
+    socklen_t length = resolveAddress(config.address, storage);
+    unsigned connectionCount = std::max(1u, config.connections);
+    unsigned pipeline = std::max(1u, config.pipeline);
+    if (length == 0) {
+        std::fprintf(stderr, "calendar_converter: bad address %s\n", config.address.c_str());
+        return false;
+    }
+
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    std::vector<LoadConnection> connections(connectionCount);
+    for (unsigned c = 0; c < connectionCount; c++) {
+        int fd = socket(storage.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&storage), length) != 0) {
+            std::fprintf(stderr, "calendar_converter: cannot connect to %s\n", config.address.c_str());
+            if (fd >= 0) close(fd);
+            for (unsigned k = 0; k < c; k++) close(connections[k].fd);
+            close(epollFd);
+            return false;
+        }
+        setNoDelay(fd, config.address);
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        connections[c].fd = fd;
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.u32 = c;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+    }
+
+    std::vector<ServerRequest> mix = makeRequestMix(config.bahereHasabPercent);
+    std::vector<LoadClock::time_point> sentAt(connectionCount * pipeline);
+    std::vector<std::uint32_t> mixIndex(connectionCount * pipeline);
+    std::vector<std::uint32_t> latenciesNs;
+    latenciesNs.reserve((std::size_t)config.requests);
+    unsigned long long sent = 0, received = 0, errors = 0;
+
+    // Put a request into `slot` and queue it on its connection
+    auto issue = [&](std::uint32_t slot) {
+        ServerRequest request = mix[sent % mix.size()];
+        request.tag = slot;
+        mixIndex[slot] = (std::uint32_t)(sent % mix.size());
+        sentAt[slot] = LoadClock::now();
+        const char* bytes = reinterpret_cast<const char*>(&request);
+        LoadConnection& connection = connections[slot / pipeline];
+        connection.output.insert(connection.output.end(), bytes, bytes + sizeof(request));
+        sent++;
+    };
+    auto flush = [&](LoadConnection& connection) {
+        std::size_t offset = 0;
+        while (offset < connection.output.size()) {
+            ssize_t n = send(connection.fd, connection.output.data() + offset, connection.output.size() - offset,
+                             MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;  // the server drains its side before it reads again; retry after the next read
+            offset += (std::size_t)n;
+        }
+        connection.output.erase(connection.output.begin(), connection.output.begin() + (long)offset);
+    };
+
+    LoadClock::time_point start = LoadClock::now();
+    for (std::uint32_t slot = 0; slot < connectionCount * pipeline && sent < config.requests; slot++) issue(slot);
+    for (LoadConnection& connection : connections) flush(connection);
+
+    epoll_event events[64];
+    bool ok = true;
+    while (received < sent && ok) {
+        int ready = epoll_wait(epollFd, events, 64, 5000);
+        if (ready == 0) {
+            std::fprintf(stderr, "calendar_converter: server stopped answering\n");
+            ok = false;
+        }
+        for (int i = 0; i < ready; i++) {
+            LoadConnection& connection = connections[events[i].data.u32];
+            ssize_t got = recv(connection.fd, connection.input.data() + connection.inputUsed,
+                               connection.input.size() - connection.inputUsed, 0);
+            if (got == 0 || (got < 0 && errno != EAGAIN && errno != EINTR)) {
+                std::fprintf(stderr, "calendar_converter: server closed the connection\n");
+                ok = false;
+                break;
+            }
+            if (got < 0) continue;
+            connection.inputUsed += (std::size_t)got;
+
+            LoadClock::time_point now = LoadClock::now();
+            std::size_t complete = connection.inputUsed / sizeof(ServerResponse);
+            for (std::size_t r = 0; r < complete; r++) {
+                ServerResponse response;
+                std::memcpy(&response, connection.input.data() + r * sizeof(ServerResponse), sizeof(response));
+                std::uint32_t slot = response.tag;
+                if (slot >= sentAt.size() || !checkResponse(mix[mixIndex[slot]], response)) errors++;
+                if (slot < sentAt.size()) {
+                    latenciesNs.push_back((std::uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                              now - sentAt[slot]).count());
+                    if (sent < config.requests) issue(slot);
+                }
+                received++;
+            }
+            std::size_t consumed = complete * sizeof(ServerResponse);
+            std::memmove(connection.input.data(), connection.input.data() + consumed, connection.inputUsed - consumed);
+            connection.inputUsed -= consumed;
+            flush(connection);
+        }
+    }
+    double seconds = std::chrono::duration<double>(LoadClock::now() - start).count();
+
+    for (LoadConnection& connection : connections) close(connection.fd);
+    close(epollFd);
+    if (latenciesNs.empty()) return false;
+
+    std::sort(latenciesNs.begin(), latenciesNs.end());
+    auto percentile = [&](double p) {
+        return latenciesNs[std::min(latenciesNs.size() - 1, (std::size_t)(p * latenciesNs.size()))] / 1000.0;
+    };
+    std::printf("%llu requests over %u connection(s), %u in flight each: %.0f requests/s\n"
+                "latency p50 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us; %llu bad responses\n",
+                received, connectionCount, pipeline, received / seconds,
+                percentile(0.50), percentile(0.99), percentile(0.999), latenciesNs.back() / 1000.0, errors);
+    return ok && errors == 0;
+}
+
+#else  // !__linux__
+
+bool runServer(const ServerConfig&) {
+    std::fprintf(stderr, "calendar_converter: server mode needs Linux (epoll)\n");
+    return false;
+}
+
+bool runLoadGenerator(const LoadGeneratorConfig&) {
+    std::fprintf(stderr, "calendar_converter: the load generator needs Linux (epoll)\n");
+    return false;
+}
+
+int openServerListener(const std::string&) {
+    return -1;
+}
+
+void closeServerListener(int, const std::string&) {}
+
+#endif
@@ -0,0 +1,80 @@
+// This file is for the conversion server (--serve) and its load generator (--loadgen)
+// the server answers fixed-size binary requests over a Unix domain socket or localhost TCP;
+// each event loop (epoll) gathers every request that arrived in one wake-up into a batch,
+// runs it through the batch kernels and writes the responses back per connection.
+// Linux only: elsewhere runServer and runLoadGenerator report an error and return false.
+
+#pragma once  // prevent multiple inclusions
+#include <cstdint>  // for fixed-width integer types
+#include <string>
+
+// Request ops
+enum ServerOp {
+    SERVER_CONVERT = 1,       // one date -> every calendar
+    SERVER_BAHERE_HASAB = 2   // one Ethiopian year -> ecclesiastical numbers and moveable feasts
+};
+
+// Response status
+enum ServerStatus {
+    SERVER_OK = 0,
+    SERVER_INVALID_DATE = 1,  // the date (or year) is outside the supported range
+    SERVER_BAD_REQUEST = 2    // unknown op or calendar
+};
+
+// Request frame, 12 bytes, native byte order (both ends are on the same host)
+struct ServerRequest {
+    std::uint32_t tag;       // echoed in the response; lets clients pipeline requests
+    std::uint8_t op;         // ServerOp
+    std::uint8_t calendar;   // SERVER_CONVERT: CalendarType of the date
+    std::uint8_t day;        // SERVER_CONVERT only
+    std::uint8_t month;      // SERVER_CONVERT only
+    std::int32_t year;       // date year, or the Ethiopian year for SERVER_BAHERE_HASAB
+};
+
+struct ServerDate {
+    std::int16_t year;
+    std::uint8_t month;
+    std::uint8_t day;
+};
+
+// Response frame, 40 bytes; responses on a connection come back in request order
+struct ServerResponse {
+    std::uint32_t tag;
+    std::uint8_t status;     // ServerStatus
+    std::uint8_t op;
+    std::uint8_t ayyaana;    // SERVER_CONVERT: index into SIDAMA_AYYAANA
+    std::uint8_t wengelawi;  // SERVER_BAHERE_HASAB: index into WENGELAWI_LIST
+    std::int32_t value;      // SERVER_CONVERT: the JDN; SERVER_BAHERE_HASAB: Amete Alem
+    std::uint8_t wenber;     // SERVER_BAHERE_HASAB only
+    std::uint8_t abekte;
+    std::uint8_t metqi;
+    std::uint8_t reserved;
+    // SERVER_CONVERT: Gregorian, Ethiopian, Islamic (dates[3..5] unused);
+    // SERVER_BAHERE_HASAB: the moveable feasts, FEAST_NINEVEH .. FEAST_FASIKA
+    ServerDate dates[6];
+};
+
+// Address: a Unix socket path, or "tcp:PORT" for 127.0.0.1:PORT
+struct ServerConfig {
+    std::string address;
+    unsigned threads = 1;  // event loops; connections are spread across them
+};
+
+// Serve until SIGINT or SIGTERM. Returns false if the socket cannot be set up.
+bool runServer(const ServerConfig& config);
+
+struct LoadGeneratorConfig {
+    std::string address;
+    unsigned connections = 4;
+    unsigned pipeline = 16;                  // requests in flight per connection
+    unsigned long long requests = 1000000;   // in total
+    unsigned bahereHasabPercent = 10;        // share of SERVER_BAHERE_HASAB requests
+};
+
+// Drive a running server and print throughput and latency percentiles to stdout
+bool runLoadGenerator(const LoadGeneratorConfig& config);
+
+// A non-blocking listening socket on a server address (also used by the metrics endpoint);
+// returns -1 on failure. closeServerListener also removes a Unix socket file.
+int openServerListener(const std::string& address);
+void closeServerListener(int fd, const std::string& address);
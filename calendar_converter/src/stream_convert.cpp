@@ -0,0 +1,584 @@
+#include "stream_convert.h"  // stream mode declarations
+#include "batch.h"           // block conversion kernels
+#include "calendar_core.h"   // for calendar dispatch
+#include "calendar_extended.h"  // for --extended years
+#include "metrics.h"         // conversion counters and block latency
+#include <chrono>            // for per-stage timing
+#include <condition_variable>
+#include <cstring>           // for std::memcpy / std::memmove / std::strlen
+#include <deque>             // for the per-worker queues
+#include <memory>            // for std::unique_ptr
+#include <mutex>
+#include <thread>
+#include <vector>
+
+const std::size_t STREAM_BLOCK_ROWS = 4096;
+const std::size_t STREAM_INPUT_BYTES = 1 << 20;
+const std::size_t STREAM_OUTPUT_BYTES = 1 << 20;
+// Longest row: four "dd/mm/yyyyy" columns (or a name), separators and the newline
+const std::size_t STREAM_MAX_ROW_BYTES = 128;
+// Parsed numbers saturate here (far past any valid date part, extended years included),
+// so they cannot overflow
+const int STREAM_MAX_NUMBER = 100000000;
+
+bool parseStreamCalendar(const std::string& name, CalendarType& type) {
+    if (name == "greg" || name == "gregorian") type = GREGORIAN;
+    else if (name == "eth" || name == "ethiopian") type = ETHIOPIAN;
+    else if (name == "islamic" || name == "hijri") type = ISLAMIC;
+    else if (name == "julian") type = JULIAN;
+    else if (name == "coptic") type = COPTIC;
+    else return false;
+    return true;
+}
+
+bool parseStreamColumns(const std::string& list, std::vector<StreamColumn>& columns) {
+    columns.clear();
+    std::size_t start = 0;
+    while (start <= list.size()) {
+        std::size_t comma = list.find(',', start);
+        if (comma == std::string::npos) comma = list.size();
+        std::string name = list.substr(start, comma - start);
+        CalendarType type;
+        if (name == "sidama" || name == "ayyaana") columns.push_back(STREAM_SIDAMA);
+        else if (!parseStreamCalendar(name, type)) return false;
+        else if (type == GREGORIAN) columns.push_back(STREAM_GREGORIAN);
+        else if (type == ETHIOPIAN) columns.push_back(STREAM_ETHIOPIAN);
+        else if (type == ISLAMIC) columns.push_back(STREAM_ISLAMIC);
+        else return false;  // Julian and Coptic are input calendars only
+        start = comma + 1;
+    }
+    return !columns.empty();
+}
+
+bool parseStreamRepair(const std::string& name, DateRepair& repair) {
+    if (name == "reject") repair = REJECT_INVALID;
+    else if (name == "clamp") repair = CLAMP_TO_MONTH_END;
+    else if (name == "roll") repair = ROLL_OVER;
+    else return false;
+    return true;
+}
+
+// Output buffer; rows are formatted straight into it. With a file it is written out whenever it
+// fills up; without one (a pipeline chunk) it grows instead.
+class StreamOutput {
+public:
+    explicit StreamOutput(std::FILE* file = nullptr) : file(file), buffer(STREAM_OUTPUT_BYTES) {}
+
+    // Make room for one more row
+    char* reserveRow() {
+        if (buffer.size() - used < STREAM_MAX_ROW_BYTES) {
+            if (file) flush();
+            else buffer.resize(buffer.size() * 2);
+        }
+        return buffer.data() + used;
+    }
+    void commit(char* end) { used = (std::size_t)(end - buffer.data()); }
+
+    const char* data() const { return buffer.data(); }
+    std::size_t size() const { return used; }
+    void clear() { used = 0; }
+
+    bool flush() {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if (used > 0 && std::fwrite(buffer.data(), 1, used, file) != used) failed = true;
+        used = 0;
+        flushSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return !failed;
+    }
+
+    double flushSeconds = 0;  // time spent writing to the file
+
+private:
+    std::FILE* file;
+    std::vector<char> buffer;
+    std::size_t used = 0;
+    bool failed = false;
+};
+
+static char* writeNumber(char* p, int value) {
+    char digits[12];
+    char* end = digits + sizeof(digits);
+    char* d = end;
+    unsigned magnitude = value < 0 ? 0u - (unsigned)value : (unsigned)value;
+    do {
+        *--d = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (value < 0) *--d = '-';
+    std::memcpy(p, d, (std::size_t)(end - d));
+    return p + (end - d);
+}
+
+// Formatting tables: "d/m/" for every day and month, and the digits of every year up to 9999.
+// Entries are copied 8 (or 4) bytes at a time and the write position advances by the real length;
+// rows reserve STREAM_MAX_ROW_BYTES, so the extra bytes always land inside the buffer.
+struct DateText {
+    char dayMonth[32 * 16][8];  // [day * 16 + month], length in the last byte
+    char year[10000][4];        // used for four-digit years
+    DateText() {
+        for (int day = 0; day < 32; day++) {
+            for (int month = 0; month < 16; month++) {
+                char* entry = dayMonth[day * 16 + month];
+                char* p = writeNumber(entry, day);
+                *p++ = '/';
+                p = writeNumber(p, month);
+                *p++ = '/';
+                entry[7] = (char)(p - entry);
+            }
+        }
+        for (int y = 0; y < 10000; y++) {
+            year[y][0] = (char)('0' + y / 1000);
+            year[y][1] = (char)('0' + y / 100 % 10);
+            year[y][2] = (char)('0' + y / 10 % 10);
+            year[y][3] = (char)('0' + y % 10);
+        }
+    }
+};
+static const DateText dateText;
+
+static char* writeDate(char* p, int day, int month, int year) {
+    if ((unsigned)day < 32 && (unsigned)month < 16) {
+        const char* entry = dateText.dayMonth[day * 16 + month];
+        std::memcpy(p, entry, 8);
+        p += entry[7];
+    } else {
+        p = writeNumber(p, day);
+        *p++ = '/';
+        p = writeNumber(p, month);
+        *p++ = '/';
+    }
+    if (year < 1000 || year > 9999) return writeNumber(p, year);
+    std::memcpy(p, dateText.year[year], 4);
+    return p + 4;
+}
+
+// Rows parsed from the input and their converted columns, one block at a time
+struct StreamBlock {
+    int day[STREAM_BLOCK_ROWS];
+    int month[STREAM_BLOCK_ROWS];
+    int year[STREAM_BLOCK_ROWS];
+    std::uint64_t validMask[validityMaskWords(STREAM_BLOCK_ROWS)];
+    std::uint64_t wideMask[validityMaskWords(STREAM_BLOCK_ROWS)];  // --extended rows outside years 1-5000
+    long jdn[STREAM_BLOCK_ROWS];
+    int out[3][3][STREAM_BLOCK_ROWS];  // [gregorian/ethiopian/islamic][day/month/year]
+    int ayyaana[STREAM_BLOCK_ROWS];
+    std::size_t count;
+};
+
+typedef std::chrono::steady_clock StreamClock;
+
+static double secondsSince(StreamClock::time_point start) {
+    return std::chrono::duration<double>(StreamClock::now() - start).count();
+}
+
+// normalizeDatesBatch for one --extended row outside its years; true if the date is (now) valid
+static bool normalizeExtendedDate(int& day, int& month, int& year, CalendarType calendar, DateRepair repair) {
+    if (isValidExtendedDate(day, month, year, calendar)) return true;
+    if (repair == REJECT_INVALID || day > 31 || !isValidExtendedDate(1, month, year, calendar)) return false;
+    int length = visitCalendar(calendar, [&](auto tag) { return wideMonthLength<decltype(tag)>(month, year); });
+    if (day <= length) return false;  // day < 1
+    if (repair == CLAMP_TO_MONTH_END) {
+        day = length;
+        return true;
+    }
+    day -= length;
+    if (month < monthsInYear(calendar)) {
+        month++;
+    } else {
+        month = 1;
+        year++;
+    }
+    return isValidExtendedDate(day, month, year, calendar);
+}
+
+static void convertBlock(const StreamConversionOptions& options, StreamBlock& block, StreamOutput& output,
+                         StreamConversionStats& stats) {
+    MetricTimer timer(METRIC_STREAM_BLOCK);
+    unsigned long long invalidBefore = stats.invalid;
+    StreamClock::time_point start = StreamClock::now();
+    std::size_t n = block.count;
+    // Validate (or repair) the whole block at once; invalid rows still go through the kernels,
+    // so give them a harmless date
+    DateColumns dates = {block.day, block.month, block.year};
+    std::size_t wideRows = 0;
+    if (normalizeDatesBatch(dates, n, options.from, options.repair, block.validMask) != n) {
+        for (std::size_t word = 0; word < validityMaskWords(n); word++) block.wideMask[word] = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            if (isValidInMask(block.validMask, i)) continue;
+            if (options.extended && normalizeExtendedDate(block.day[i], block.month[i], block.year[i], options.from,
+                                                          options.repair)) {
+                block.validMask[i / 64] |= std::uint64_t(1) << (i % 64);
+                block.wideMask[i / 64] |= std::uint64_t(1) << (i % 64);
+                wideRows++;
+                continue;
+            }
+            block.day[i] = 1;
+            block.month[i] = 1;
+            block.year[i] = 2000;
+        }
+    }
+    if (options.from == GREGORIAN || options.from == ETHIOPIAN) {
+        datesToJDNBatch(block.day, block.month, block.year, n, block.jdn, options.from == GREGORIAN);
+    } else {
+        // One loop per calendar tag, so the calendar is not re-dispatched per row
+        visitCalendar(options.from, [&](auto calendar) {
+            for (std::size_t i = 0; i < n; i++) {
+                block.jdn[i] = decltype(calendar)::toJDN(block.day[i], block.month[i], block.year[i]);
+            }
+        });
+    }
+
+    // The kernels above stay in 32 bits, which is exact for years 1-5000 only
+    for (std::size_t i = 0; wideRows > 0 && i < n; i++) {
+        if (!isValidInMask(block.wideMask, i)) continue;
+        block.jdn[i] = (long)extendedCalendarToJDN(options.from, block.day[i], block.month[i], block.year[i]);
+        wideRows--;
+    }
+
+    // Only compute the calendars that are written out
+    BatchConversionOutput columns = {};
+    for (StreamColumn column : options.columns) {
+        if (column == STREAM_SIDAMA) {
+            columns.ayyaana = block.ayyaana;
+        } else {
+            DateColumns& target = column == STREAM_GREGORIAN ? columns.gregorian
+                                  : column == STREAM_ETHIOPIAN ? columns.ethiopian : columns.islamic;
+            target = {block.out[column][0], block.out[column][1], block.out[column][2]};
+        }
+    }
+    convertJDNBatch(block.jdn, n, columns);
+    StreamClock::time_point converted = StreamClock::now();
+    double flushedBefore = output.flushSeconds;
+
+    for (std::size_t i = 0; i < n; i++) {
+        char* p = output.reserveRow();
+        if (!isValidInMask(block.validMask, i)) {
+            std::memcpy(p, "invalid\n", 8);
+            output.commit(p + 8);
+            stats.invalid++;
+            continue;
+        }
+        for (std::size_t c = 0; c < options.columns.size(); c++) {
+            if (c > 0) *p++ = ',';
+            StreamColumn column = options.columns[c];
+            if (column == STREAM_SIDAMA) {
+                const char* name = SIDAMA_AYYAANA[block.ayyaana[i]];
+                std::size_t length = std::strlen(name);
+                std::memcpy(p, name, length);
+                p += length;
+            } else {
+                p = writeDate(p, block.out[column][0][i], block.out[column][1][i], block.out[column][2][i]);
+            }
+        }
+        *p++ = '\n';
+        output.commit(p);
+    }
+    stats.rows += n;
+    block.count = 0;
+    std::size_t invalid = (std::size_t)(stats.invalid - invalidBefore);
+    countInvalidDates(options.from, invalid);
+    for (StreamColumn column : options.columns) {
+        countConversions(options.from, (ConversionTarget)(TO_GREGORIAN + column), n - invalid);
+    }
+
+    stats.times.convert += std::chrono::duration<double>(converted - start).count();
+    // Buffer flushes during formatting count as writing
+    double flushed = output.flushSeconds - flushedBefore;
+    stats.times.format += secondsSince(converted) - flushed;
+    stats.times.write += flushed;
+}
+
+// Parse the complete lines in [p, end) into the block, converting whenever it fills up.
+// *end must be '\n': the sentinel lets the loops below test only for digits and newlines.
+static void parseLines(const char* p, const char* end, const StreamConversionOptions& options, StreamBlock& block,
+                       StreamOutput& output, StreamConversionStats& stats) {
+    while (p < end) {
+        int values[3] = {0, 0, 0};
+        int numbers = 0;
+        bool negative = false;
+        while (*p != '\n') {
+            unsigned digit = (unsigned)(*p - '0');
+            if (digit >= 10) {
+                negative = options.extended && *p == '-';
+                p++;
+                continue;
+            }
+            int value = (int)digit;
+            while ((digit = (unsigned)(*++p - '0')) < 10) {
+                value = value * 10 + (int)digit;
+                if (value > STREAM_MAX_NUMBER) value = STREAM_MAX_NUMBER;
+            }
+            if (numbers < 3) values[numbers] = negative ? -value : value;
+            numbers++;
+            negative = false;
+            if (*p == '-') p++;  // "7-9-2024": a '-' that ends a number is a separator, not a sign
+        }
+        p++;  // the newline
+        if (numbers == 0) continue;
+
+        std::size_t row = block.count++;
+        // Validated a block at a time in convertBlock; month 0 is never valid
+        block.day[row] = values[0];
+        block.month[row] = numbers == 3 ? values[1] : 0;
+        block.year[row] = values[2];
+        if (block.count == STREAM_BLOCK_ROWS) convertBlock(options, block, output, stats);
+    }
+}
+
+// Convert the lines in [begin, end) completely (including a final partial block);
+// parse time is what remains of the elapsed time after conversion, formatting and writing
+static void convertText(const char* begin, const char* end, const StreamConversionOptions& options,
+                        StreamBlock& block, StreamOutput& output, StreamConversionStats& stats) {
+    StreamClock::time_point start = StreamClock::now();
+    double before = stats.times.convert + stats.times.format + stats.times.write;
+    parseLines(begin, end, options, block, output, stats);
+    if (block.count > 0) convertBlock(options, block, output, stats);
+    stats.times.parse += secondsSince(start) - (stats.times.convert + stats.times.format + stats.times.write - before);
+}
+
+// Read up to STREAM_INPUT_BYTES into `buffer` after the `carried` bytes already there.
+// Returns the length of the complete lines at the front (everything at end of input) and
+// sets `filled` to the total; a sentinel '\n' is written after the complete lines.
+static std::size_t readLines(std::FILE* in, char* buffer, std::size_t carried, std::size_t& filled, bool& atEnd,
+                             StreamConversionStats& stats) {
+    StreamClock::time_point start = StreamClock::now();
+    std::size_t got = std::fread(buffer + carried, 1, STREAM_INPUT_BYTES - carried, in);
+    stats.times.read += secondsSince(start);
+    filled = carried + got;
+    atEnd = got == 0;
+
+    std::size_t complete = filled;
+    if (!atEnd) {
+        while (complete > 0 && buffer[complete - 1] != '\n') complete--;
+        if (complete == 0) complete = filled;  // a single line longer than the buffer: parse it as is
+    }
+    return complete;
+}
+
+static bool runSequential(const StreamConversionOptions& options, std::FILE* in, std::FILE* out,
+                          StreamConversionStats& stats) {
+    StreamOutput output(out);
+    std::vector<char> input(STREAM_INPUT_BYTES + 1);  // + the sentinel
+    std::unique_ptr<StreamBlock> block(new StreamBlock);
+    block->count = 0;
+
+    // A line cut off at the end of a read is carried over to the next one
+    std::size_t carried = 0;
+    while (true) {
+        std::size_t filled;
+        bool atEnd;
+        std::size_t complete = readLines(in, input.data(), carried, filled, atEnd, stats);
+        char saved = input[complete];
+        input[complete] = '\n';
+        convertText(input.data(), input.data() + complete, options, *block, output, stats);
+        input[complete] = saved;
+
+        carried = filled - complete;
+        std::memmove(input.data(), input.data() + complete, carried);
+        if (atEnd) break;
+    }
+
+    double flushedBefore = output.flushSeconds;
+    bool ok = output.flush();
+    stats.times.write += output.flushSeconds - flushedBefore;
+    return ok && !std::ferror(in);
+}
+
+// Parallel pipeline
+//
+// The calling thread reads newline-aligned chunks and deals them out round-robin to per-worker
+// queues. Each worker converts a chunk into the chunk's own output buffer; a worker whose queue is
+// empty steals the oldest chunk from another queue. A writer thread emits finished chunks strictly
+// in input order. A fixed pool of chunks bounds memory: the reader waits for a free one.
+
+struct StreamChunk {
+    std::size_t sequence;
+    std::vector<char> input = std::vector<char>(STREAM_INPUT_BYTES + 1);  // + the sentinel
+    std::size_t length = 0;  // bytes of complete lines in `input`
+    StreamOutput output;
+    bool done = false;
+};
+
+class StreamPipeline {
+public:
+    StreamPipeline(const StreamConversionOptions& options, std::FILE* out, unsigned threads);
+    bool run(std::FILE* in, StreamConversionStats& stats);
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<StreamChunk*> chunks;
+    };
+
+    StreamChunk* takeFreeChunk();
+    StreamChunk* takeWork(unsigned worker);
+    void work(unsigned worker);
+    void writeInOrder();
+
+    const StreamConversionOptions& options;
+    std::FILE* out;
+    unsigned threads;
+
+    std::vector<std::unique_ptr<StreamChunk>> pool;
+    std::vector<StreamChunk*> freeChunks;
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<StreamConversionStats> workerStats;
+
+    std::mutex mutex;                   // guards freeChunks, pending, inputDone, the done flags
+    std::condition_variable freed;      // reader waits for a free chunk
+    std::condition_variable workReady;  // idle workers wait here
+    std::condition_variable chunkDone;  // writer waits for the next chunk in order
+    std::size_t pending = 0;            // chunks queued but not yet taken by a worker
+    std::size_t produced = 0;           // chunks handed out by the reader
+    bool inputDone = false;
+
+    bool writeFailed = false;  // writer thread only until joined
+    double writeSeconds = 0;
+};
+
+StreamPipeline::StreamPipeline(const StreamConversionOptions& options, std::FILE* out, unsigned threads)
+    : options(options), out(out), threads(threads), workerStats(threads, StreamConversionStats()) {
+    // Two chunks per worker keeps every worker busy while the writer catches up
+    for (unsigned i = 0; i < 2 * threads + 2; i++) {
+        pool.emplace_back(new StreamChunk);
+        freeChunks.push_back(pool.back().get());
+    }
+    for (unsigned i = 0; i < threads; i++) queues.emplace_back(new WorkerQueue);
+}
+
+StreamChunk* StreamPipeline::takeFreeChunk() {
+    std::unique_lock<std::mutex> lock(mutex);
+    freed.wait(lock, [&] { return !freeChunks.empty(); });
+    StreamChunk* chunk = freeChunks.back();
+    freeChunks.pop_back();
+    return chunk;
+}
+
+// Own queue first, then steal; returns nullptr once the input is exhausted and nothing is left
+StreamChunk* StreamPipeline::takeWork(unsigned worker) {
+    while (true) {
+        for (unsigned i = 0; i < threads; i++) {
+            WorkerQueue& queue = *queues[(worker + i) % threads];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.chunks.empty()) continue;
+            StreamChunk* chunk = queue.chunks.front();
+            queue.chunks.pop_front();
+            std::lock_guard<std::mutex> countLock(mutex);
+            pending--;
+            return chunk;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        workReady.wait(lock, [&] { return pending > 0 || inputDone; });
+        if (pending == 0 && inputDone) return nullptr;
+    }
+}
+
+void StreamPipeline::work(unsigned worker) {
+    std::unique_ptr<StreamBlock> block(new StreamBlock);
+    block->count = 0;
+    while (StreamChunk* chunk = takeWork(worker)) {
+        chunk->output.clear();
+        convertText(chunk->input.data(), chunk->input.data() + chunk->length, options, *block, chunk->output,
+                    workerStats[worker]);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            chunk->done = true;
+        }
+        chunkDone.notify_all();
+    }
+}
+
+void StreamPipeline::writeInOrder() {
+    for (std::size_t next = 0;; next++) {
+        StreamChunk* chunk = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            chunkDone.wait(lock, [&] {
+                if (inputDone && next == produced) return true;
+                for (const auto& candidate : pool) {
+                    if (candidate->done && candidate->sequence == next) {
+                        chunk = candidate.get();
+                        return true;
+                    }
+                }
+                return false;
+            });
+            if (!chunk) return;  // everything has been written
+        }
+
+        StreamClock::time_point start = StreamClock::now();
+        std::size_t size = chunk->output.size();
+        if (!writeFailed && size > 0 && std::fwrite(chunk->output.data(), 1, size, out) != size) writeFailed = true;
+        writeSeconds += secondsSince(start);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            chunk->done = false;
+            freeChunks.push_back(chunk);
+        }
+        freed.notify_one();
+    }
+}
+
+bool StreamPipeline::run(std::FILE* in, StreamConversionStats& stats) {
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threads; i++) workers.emplace_back(&StreamPipeline::work, this, i);
+    std::thread writer(&StreamPipeline::writeInOrder, this);
+
+    // Reader: the tail after the last newline of one chunk starts the next one
+    std::vector<char> carry;
+    for (std::size_t sequence = 0;; sequence++) {
+        StreamChunk* chunk = takeFreeChunk();
+        std::memcpy(chunk->input.data(), carry.data(), carry.size());
+        std::size_t filled;
+        bool atEnd;
+        chunk->length = readLines(in, chunk->input.data(), carry.size(), filled, atEnd, stats);
+        carry.assign(chunk->input.begin() + (long)chunk->length, chunk->input.begin() + (long)filled);
+        chunk->input[chunk->length] = '\n';
+        chunk->sequence = sequence;
+
+        {
+            std::lock_guard<std::mutex> lock(queues[sequence % threads]->mutex);
+            queues[sequence % threads]->chunks.push_back(chunk);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending++;
+            produced++;
+            inputDone = atEnd;
+        }
+        workReady.notify_one();
+        if (atEnd) break;
+    }
+    workReady.notify_all();
+    chunkDone.notify_all();
+
+    for (std::thread& worker : workers) worker.join();
+    chunkDone.notify_all();
+    writer.join();
+
+    for (const StreamConversionStats& worker : workerStats) {
+        stats.rows += worker.rows;
+        stats.invalid += worker.invalid;
+        stats.times.parse += worker.times.parse;
+        stats.times.convert += worker.times.convert;
+        stats.times.format += worker.times.format;
+    }
+    stats.times.write = writeSeconds;
+    return !writeFailed && std::fflush(out) == 0 && !std::ferror(in);
+}
+
+bool runStreamConversion(const StreamConversionOptions& options, std::FILE* in, std::FILE* out,
+                         StreamConversionStats& stats) {
+    stats = StreamConversionStats();
+    StreamClock::time_point start = StreamClock::now();
+    bool ok;
+    if (options.threads <= 1) {
+        ok = runSequential(options, in, out, stats);
+    } else {
+        StreamPipeline pipeline(options, out, options.threads);
+        ok = pipeline.run(in, stats);
+    }
+    stats.times.total = secondsSince(start);
+    return ok;
+}
@@ -0,0 +1,62 @@
+// This file is for the non-interactive stream mode (--convert)
+// it reads one date per line, converts blocks of rows through the batch kernels and writes one
+// row per date, using large buffered reads/writes and its own integer parser and formatter
+
+#pragma once  // prevent multiple inclusions
+#include "batch.h"  // for DateRepair
+#include "data.h"
+#include <cstdio>  // for std::FILE
+#include <string>
+#include <vector>
+
+// Output columns, written in the order they were requested
+enum StreamColumn {
+    STREAM_GREGORIAN,  // d/m/y
+    STREAM_ETHIOPIAN,  // d/m/y
+    STREAM_ISLAMIC,    // d/m/y
+    STREAM_SIDAMA      // Ayyaana name
+};
+
+struct StreamConversionOptions {
+    CalendarType from = GREGORIAN;
+    std::vector<StreamColumn> columns = {STREAM_GREGORIAN, STREAM_ETHIOPIAN, STREAM_ISLAMIC, STREAM_SIDAMA};
+    // Worker threads; above 1 the input is split into chunks that are converted in parallel
+    // and written back in input order
+    unsigned threads = 1;
+    // Days past the end of their month ("29/2/2023") are rejected, or clamped / rolled over
+    DateRepair repair = REJECT_INVALID;
+    // Accept years -1,000,000 to 1,000,000 (astronomical: 0 is the year before 1) instead of 1-5000;
+    // a '-' right before a number that does not directly follow another number makes it negative
+    bool extended = false;
+};
+
+// Seconds spent in each stage; parse, convert and format are summed over all workers
+struct StreamStageTimes {
+    double read;
+    double parse;
+    double convert;
+    double format;
+    double write;
+    double total;  // wall-clock time of the whole run
+};
+
+struct StreamConversionStats {
+    unsigned long long rows;     // rows written
+    unsigned long long invalid;  // rows written as "invalid"
+    StreamStageTimes times;
+};
+
+// "greg"/"gregorian", "eth"/"ethiopian", "islamic"/"hijri"; returns false for anything else
+bool parseStreamCalendar(const std::string& name, CalendarType& type);
+// Comma-separated list of calendars plus "sidama"/"ayyaana", e.g. "greg,islamic,sidama"
+bool parseStreamColumns(const std::string& list, std::vector<StreamColumn>& columns);
+// "reject", "clamp" or "roll"
+bool parseStreamRepair(const std::string& name, DateRepair& repair);
+
+// Convert every line of `in` and write the rows to `out`.
+// A line holds day, month and year separated by any non-digit characters ("7/9/2024", "7 9 2024");
+// lines without digits are skipped, and a line that is not a valid date (after options.repair)
+// produces the row "invalid", so output row n always belongs to the n-th non-blank input line.
+// Columns are separated by ',' and dates written as d/m/y. Returns false on a read or write error.
+bool runStreamConversion(const StreamConversionOptions& options, std::FILE* in, std::FILE* out,
+                         StreamConversionStats& stats);
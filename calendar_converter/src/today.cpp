@@ -0,0 +1,177 @@
+#include "today.h"       // cached current date declarations
+#include "conversion.h"  // for convertJDN
+#include <atomic>
+#include <chrono>              // for the timer deadline
+#include <condition_variable>  // for the timer thread's sleep
+#include <cstdio>              // for std::snprintf
+#include <cstring>             // for std::memcpy
+#include <memory>              // for std::unique_ptr
+#include <mutex>
+#include <thread>
+
+// JDN of 1 January 1970, the day std::time_t counts from
+static const long UNIX_EPOCH_JDN = 2440588;
+static const long SECONDS_PER_DAY = 86400;
+
+static void localTime(std::time_t t, std::tm& tm) {
+#ifdef _WIN32
+    localtime_s(&tm, &t);
+#else
+    localtime_r(&t, &tm);
+#endif
+}
+
+// Local time - UTC at `t`: the broken-down local time read back as if it were UTC, minus `t`
+// (portable, unlike tm_gmtoff)
+static long utcOffsetAt(std::time_t t) {
+    std::tm tm;
+    localTime(t, tm);
+    long days = gregorianToJDN(tm.tm_mday, tm.tm_mon + 1, tm.tm_year + 1900) - UNIX_EPOCH_JDN;
+    return (long)(days * SECONDS_PER_DAY + tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec - t);
+}
+
+// The first second of (lo, hi] whose UTC offset differs from lo's, given that hi's does
+// (offsets change at most once a day, so the change is unique)
+static std::time_t offsetChangeAfter(std::time_t lo, std::time_t hi) {
+    long offset = utcOffsetAt(lo);
+    while (hi - lo > 1) {
+        std::time_t mid = lo + (hi - lo) / 2;
+        if (utcOffsetAt(mid) == offset) lo = mid;
+        else hi = mid;
+    }
+    return hi;
+}
+
+// Local midnight starting the day `days` after the local date in `tm`
+static std::time_t localMidnight(std::tm tm, int days) {
+    tm.tm_mday += days;
+    tm.tm_hour = tm.tm_min = tm.tm_sec = 0;
+    tm.tm_isdst = -1;  // let mktime decide
+    return std::mktime(&tm);
+}
+
+static TodaySnapshot makeSnapshot(std::time_t now) {
+    std::tm tm;
+    localTime(now, tm);
+    TodaySnapshot snapshot;
+    convertJDN(gregorianToJDN(tm.tm_mday, tm.tm_mon + 1, tm.tm_year + 1900), snapshot.date);
+    snapshot.weekday = tm.tm_wday;
+    snapshot.utcOffset = utcOffsetAt(now);
+
+    snapshot.validFrom = localMidnight(tm, 0);
+    snapshot.validUntil = localMidnight(tm, 1);
+    if (snapshot.validFrom > now) snapshot.validFrom = now;  // no midnight today (a skipped hour)
+    if (utcOffsetAt(snapshot.validFrom) != snapshot.utcOffset) {
+        snapshot.validFrom = offsetChangeAfter(snapshot.validFrom, now);
+    }
+    if (utcOffsetAt(snapshot.validUntil - 1) != snapshot.utcOffset) {
+        snapshot.validUntil = offsetChangeAfter(now, snapshot.validUntil - 1);
+    }
+
+    const CalendarDate& greg = snapshot.date.gregorian;
+    std::snprintf(snapshot.dateText, sizeof(snapshot.dateText), "%04d-%02d-%02d", greg.year, greg.month, greg.day);
+    return snapshot;
+}
+
+// Readers load `currentSnapshot` and nothing else. Replaced snapshots are kept (one per day, a few
+// dozen bytes) so a reference handed out by today() never dangles.
+static std::atomic<const TodaySnapshot*> currentSnapshot{nullptr};
+static std::mutex refreshMutex;
+
+static bool covers(const TodaySnapshot* snapshot, std::time_t t) {
+    return snapshot && t >= snapshot->validFrom && t < snapshot->validUntil;
+}
+
+static void startRefreshThread();
+
+static const TodaySnapshot* refreshSnapshot() {
+    std::lock_guard<std::mutex> lock(refreshMutex);
+    std::time_t now = std::time(nullptr);
+    const TodaySnapshot* snapshot = currentSnapshot.load(std::memory_order_acquire);
+    if (covers(snapshot, now)) return snapshot;  // another thread got here first
+    snapshot = new TodaySnapshot(makeSnapshot(now));
+    currentSnapshot.store(snapshot, std::memory_order_release);
+    return snapshot;
+}
+
+const TodaySnapshot& today() {
+    const TodaySnapshot* snapshot = currentSnapshot.load(std::memory_order_acquire);
+    if (!covers(snapshot, std::time(nullptr))) {
+        // The timer starts with the first snapshot; its own refreshes never come here
+        bool first = snapshot == nullptr;
+        snapshot = refreshSnapshot();
+        if (first) startRefreshThread();
+    }
+    return *snapshot;
+}
+
+void formatLocalTimestamp(std::time_t timestamp, char* out) {
+    const TodaySnapshot& snapshot = today();
+    if (!covers(&snapshot, timestamp)) {
+        std::tm tm;
+        localTime(timestamp, tm);
+        std::strftime(out, LOCAL_TIMESTAMP_BYTES, "%Y-%m-%d %H:%M:%S", &tm);
+        return;
+    }
+    long seconds = (long)((timestamp + snapshot.utcOffset) % SECONDS_PER_DAY);
+    if (seconds < 0) seconds += SECONDS_PER_DAY;
+    int fields[3] = {(int)(seconds / 3600), (int)(seconds / 60 % 60), (int)(seconds % 60)};
+    std::memcpy(out, snapshot.dateText, 10);
+    for (int i = 0; i < 3; i++) {
+        out[10 + 3 * i] = i == 0 ? ' ' : ':';
+        out[11 + 3 * i] = (char)('0' + fields[i] / 10);
+        out[12 + 3 * i] = (char)('0' + fields[i] % 10);
+    }
+    out[19] = '\0';
+}
+
+// The timer: sleeps until the current snapshot expires, then replaces it
+class TodayClock {
+public:
+    TodayClock() : thread(&TodayClock::run, this) {}
+    ~TodayClock() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopRequested = true;
+        }
+        wakeup.notify_one();
+        thread.join();
+    }
+
+private:
+    void run() {
+        while (true) {
+            std::time_t until = today().validUntil;  // refreshes an expired snapshot
+            std::unique_lock<std::mutex> lock(mutex);
+            auto deadline = std::chrono::system_clock::from_time_t(until);
+            if (wakeup.wait_until(lock, deadline, [this] { return stopRequested; })) return;
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    bool stopRequested = false;
+    std::thread thread;
+};
+
+static std::mutex lifecycleMutex;
+static std::unique_ptr<TodayClock> clockInstance;
+static bool clockStopped = false;  // stopTodayClock was called: do not restart
+
+static void startRefreshThread() {
+    std::lock_guard<std::mutex> lock(lifecycleMutex);
+    if (clockInstance || clockStopped) return;
+    clockInstance.reset(new TodayClock());
+}
+
+void stopTodayClock() {
+    std::lock_guard<std::mutex> lock(lifecycleMutex);
+    clockStopped = true;
+    clockInstance.reset();
+}
+
+// Joins the timer thread when the program exits
+struct TodayClockShutdown {
+    ~TodayClockShutdown() { stopTodayClock(); }
+};
+static TodayClockShutdown shutdownAtExit;
@@ -0,0 +1,34 @@
+// This file is for the cached current date
+// today's date in every calendar is computed once per local day into an immutable snapshot that
+// readers get with one atomic load, instead of std::localtime (not thread-safe, and it takes a lock
+// in glibc) and a full conversion per call. A timer thread swaps in the next snapshot at local
+// midnight, or earlier when the UTC offset changes (daylight saving), so its clock stays exact.
+
+#pragma once  // prevent multiple inclusions
+#include "data.h"   // for ConvertedDate
+#include <cstddef>  // for std::size_t
+#include <ctime>    // for std::time_t
+
+// One local day (or the part of it with one UTC offset). Never modified or freed once published.
+struct TodaySnapshot {
+    ConvertedDate date;      // today in every calendar; date.ethiopian.year is the current Ethiopian year
+    int weekday;             // 0 = Sunday
+    std::time_t validFrom;   // local midnight, or the offset change that began this span
+    std::time_t validUntil;  // the next local midnight, or an offset change before it
+    long utcOffset;          // local time - UTC in seconds, throughout [validFrom, validUntil)
+    char dateText[11];       // "YYYY-MM-DD"
+};
+
+// Today's snapshot. Lock-free from any thread, except for the first call and the rare call that
+// finds the snapshot expired before the timer replaced it (those build the new one under a mutex).
+const TodaySnapshot& today();
+
+// "YYYY-MM-DD HH:MM:SS" in local time plus a terminating NUL
+const std::size_t LOCAL_TIMESTAMP_BYTES = 20;
+
+// Render a timestamp into `out` (LOCAL_TIMESTAMP_BYTES): arithmetic on today's snapshot when the
+// timestamp falls inside it, localtime_r otherwise
+void formatLocalTimestamp(std::time_t timestamp, char* out);
+
+// Stop the refresh thread (also done automatically at exit); today() keeps working without it
+void stopTodayClock();
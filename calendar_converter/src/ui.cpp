@@ -1,11 +1,17 @@
 #include "ui.h"
 #include "data.h"
 #include "conversion.h"
+#include "display.h"
+#include "report_writer.h"
+#include "history_log.h"
+#include "today.h"
+#include <ctime>
 #include <iostream>
 #include <fstream>
 #include <limits>
 #include <locale>
 #include <cstdio>
+#include <vector>
 
 // To clear the input buffer
 // it clears teh user input if he/she enters invalid input and loops back
@@ -57,16 +63,8 @@ void showBahereHasab() {
     std::cout << "\n=== Bahere Hasab (ባሕረ ሐሳብ) ===" << std::endl;
     std::cout << "Calculate important Ethiopian Orthodox Church dates for a given year." << std::endl;
     
-    // Get current Ethiopian year as default
-    std::time_t now = std::time(nullptr);
-    std::tm* tm_now = std::localtime(&now);
-    int current_year = tm_now->tm_year + 1900;
-    
-    // Convert to Ethiopian year (Gregorian year - 8 years, +1 if after September)
-    int default_eth_year = current_year - 8;
-    if (tm_now->tm_mon >= 8) { // September or later
-        default_eth_year++;
-    }
+    // Current Ethiopian year as default (it begins on Meskerem 1, 11 or 12 September)
+    int default_eth_year = today().date.ethiopian.year;
     
     std::cout << "\nEnter Ethiopian year (e.g., " << default_eth_year << "): ";
     
@@ -117,27 +115,22 @@ Other Features:
 }
 
 void showCurrentDate() {
-    std::time_t t = std::time(0);
-    std::tm* now = std::localtime(&t);
-    
-    int gregorianDays = now->tm_mday;
-    int gregorianMonths = now->tm_mon + 1;
-    int gregorianYears = now->tm_year + 1900;
-    
     std::cout << "\n=== Current Date ===" << std::endl;
-    convertAndDisplayDate(gregorianDays, gregorianMonths, gregorianYears, GREGORIAN);
+    displayConvertedDate(today().date, GREGORIAN);  // converted once a day, see today.h
 }
 
 void convertSpecificDate() {
     std::cout << "\n=== Date Converter ===" << std::endl;
     std::cout << "Select source calendar:\n";
-    std::cout << "1. Gregorian\n2. Ethiopian\n3. Islamic\n";
+    std::cout << "1. Gregorian\n2. Ethiopian\n3. Islamic\n4. Julian\n5. Coptic\n";
     
-    int choice = getIntInput("Enter choice (1-3): ", 1, 3);
+    int choice = getIntInput("Enter choice (1-5): ", 1, 5);
     CalendarType type = static_cast<CalendarType>(choice);
     
     std::string calendarName = (type == GREGORIAN) ? "Gregorian" : 
-                             (type == ETHIOPIAN) ? "Ethiopian" : "Islamic";
+                             (type == ETHIOPIAN) ? "Ethiopian" :
+                             (type == ISLAMIC) ? "Islamic" :
+                             (type == JULIAN) ? "Julian" : "Coptic";
     
     std::cout << "\nEnter " << calendarName << " date (DD MM YYYY): ";
     int days, month, year;
@@ -147,6 +140,74 @@ void convertSpecificDate() {
     convertAndDisplayDate(days, month, year, type);
 }
 
+// Read a Gregorian DD MM YYYY date; returns false on invalid input
+static bool readGregorianDate(const std::string& prompt, int& day, int& month, int& year) {
+    std::cout << prompt;
+    bool ok = static_cast<bool>(std::cin >> day >> month >> year);
+    clearInputBuffer();
+    return ok && isValidDate(day, month, year, GREGORIAN);
+}
+
+// Range query over the binary history, by when the conversion ran or by the date converted
+static void searchHistory(bool byConversionTime) {
+    HistoryLog log;
+    if (!log.load()) {
+        std::cout << "⚠️ No conversion history found." << std::endl;
+        return;
+    }
+
+    int fromDay, fromMonth, fromYear, toDay, toMonth, toYear;
+    if (!readGregorianDate("From (Gregorian DD MM YYYY): ", fromDay, fromMonth, fromYear) ||
+        !readGregorianDate("To   (Gregorian DD MM YYYY): ", toDay, toMonth, toYear)) {
+        std::cout << "⚠️ Invalid date!" << std::endl;
+        return;
+    }
+
+    std::vector<std::size_t> matches;
+    if (byConversionTime) {
+        // Local midnight at the start of `from` up to the last second of `to`
+        std::tm start = {};
+        start.tm_mday = fromDay;
+        start.tm_mon = fromMonth - 1;
+        start.tm_year = fromYear - 1900;
+        start.tm_isdst = -1;
+        std::tm end = {};
+        end.tm_mday = toDay + 1;
+        end.tm_mon = toMonth - 1;
+        end.tm_year = toYear - 1900;
+        end.tm_isdst = -1;
+        matches = log.queryByTime((std::int64_t)std::mktime(&start), (std::int64_t)std::mktime(&end) - 1);
+    } else {
+        matches = log.queryByJDN(dateToJDN(fromDay, fromMonth, fromYear), dateToJDN(toDay, toMonth, toYear));
+    }
+
+    std::cout << "\n=== " << matches.size() << " of " << log.size() << " conversions ===" << std::endl;
+    for (std::size_t index : matches) {
+        std::cout << log.describe(index) << '\n';
+    }
+    std::cout.flush();
+}
+
+// Write the history as columns (HistoryLog::exportColumns) for analysis tools
+static void exportHistory() {
+    HistoryLog log;
+    if (!log.load()) {
+        std::cout << "⚠️ No conversion history found." << std::endl;
+        return;
+    }
+
+    std::cout << "Export to (Enter for " << HISTORY_EXPORT_FILE << "): ";
+    std::string path;
+    std::getline(std::cin, path);
+    if (path.empty()) path = HISTORY_EXPORT_FILE;
+
+    if (log.exportColumns(path)) {
+        std::cout << "✓ Exported " << log.size() << " conversions to " << path << std::endl;
+    } else {
+        std::cout << "⚠️ Could not write " << path << std::endl;
+    }
+}
+
 void manageReportFiles() {
     while (true) {
         std::cout << "\n=== Report File Management ===" << std::endl;
@@ -154,14 +215,22 @@ void manageReportFiles() {
         std::cout << "[2] View Holidays Report (holidays_report.txt)" << std::endl;
         std::cout << "[3] Clear Conversion History" << std::endl;
         std::cout << "[4] Clear Holidays History" << std::endl;
-        std::cout << "[5] Back to Main Menu" << std::endl;
+        std::cout << "[5] Search History by Conversion Time (history.bin)" << std::endl;
+        std::cout << "[6] Search History by Converted Date (history.bin)" << std::endl;
+        std::cout << "[7] Export History as Columns (" << HISTORY_EXPORT_FILE << ")" << std::endl;
+        std::cout << "[8] Back to Main Menu" << std::endl;
         std::cout << "Choice: ";
         
         int choice;
         std::cin >> choice;
         clearInputBuffer();
         
-        if (choice == 5) break;
+        if (choice == 8) break;
+
+        // Reports are written in the background: make sure the files are complete
+        // before viewing them, and that nothing lands in them right after clearing
+        flushReports();
+        flushHistory();
         
         std::string filename;
         std::string fileDescription;
@@ -176,6 +245,7 @@ void manageReportFiles() {
                 fileDescription = "Holidays Report";
                 break;
             case 3:
+                clearHistory();
                 if (std::remove("report.txt") == 0) {
                     std::cout << "✓ Conversion history cleared successfully!" << std::endl;
                 } else {
@@ -189,6 +259,13 @@ void manageReportFiles() {
                     std::cout << "⚠️ No holidays history found or error occurred." << std::endl;
                 }
                 continue;
+            case 5:
+            case 6:
+                searchHistory(choice == 5);
+                continue;
+            case 7:
+                exportHistory();
+                continue;
             default:
                 std::cout << "⚠️ Invalid choice. Please try again." << std::endl;
                 continue;
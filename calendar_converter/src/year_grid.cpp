@@ -0,0 +1,93 @@
+#include "year_grid.h"       // grid declarations
+#include "bahere_hasab.h"    // feasts from the Paschal-cycle table
+#include "calendar_cursor.h" // to walk the year without reconverting
+#include "metrics.h"         // years served
+#include <algorithm>         // for std::min
+#include <cstring>           // for std::memset
+#include <memory>            // for std::unique_ptr
+#include <thread>
+#include <vector>
+
+bool buildYearGrid(int year, YearGrid& grid) {
+    if (year < 1 || year > 5000) return false;
+
+    grid.year = year;
+    grid.firstJdn = ethiopianToJDN(1, 1, year);
+    grid.dayCount = isEthiopianLeapYear(year) ? 366 : 365;
+    grid.bahereHasab = computeBahereHasab(year);
+    countMetric(METRIC_BAHERE_HASAB);
+    grid.feasts = feastsForYear(year);
+
+    CalendarCursor cursor(grid.firstJdn);
+    for (int i = 0; i < grid.dayCount; i++, cursor.next()) {
+        CalendarDate greg = cursor.gregorian();
+        CalendarDate hijri = cursor.islamic();
+        GridDay& day = grid.days[i];
+        day.gregorianYear = (std::int16_t)greg.year;
+        day.gregorianMonth = (std::uint8_t)greg.month;
+        day.gregorianDay = (std::uint8_t)greg.day;
+        day.islamicYear = (std::int16_t)hijri.year;
+        day.islamicMonth = (std::uint8_t)hijri.month;
+        day.islamicDay = (std::uint8_t)hijri.day;
+        day.weekday = (std::uint8_t)cursor.weekday();
+        day.ayyaana = (std::uint8_t)cursor.ayyaana();
+        day.feast = GRID_NO_FEAST;
+        day.reserved = 0;
+    }
+    if (grid.dayCount < GRID_MAX_DAYS) std::memset(&grid.days[grid.dayCount], 0, sizeof(GridDay));
+
+    // The moveable feasts always fall between Tir and Ginbot, inside the year
+    for (int f = 0; f < FEAST_COUNT; f++) {
+        const CalendarDate& date = grid.feasts.dates[f];
+        grid.days[gridIndex(date.month, date.day)].feast = (std::int8_t)f;
+    }
+    return true;
+}
+
+// Run work(i) for i in 0 .. count-1, split into contiguous ranges over up to `threads` threads
+template <typename Work>
+static void forEachYear(std::size_t count, unsigned threads, Work work) {
+    std::size_t workers = std::min<std::size_t>(threads > 0 ? threads : 1, count);
+    if (workers <= 1) {
+        for (std::size_t i = 0; i < count; i++) work(i);
+        return;
+    }
+    std::vector<std::thread> pool;
+    for (std::size_t w = 0; w < workers; w++) {
+        std::size_t begin = count * w / workers;
+        std::size_t end = count * (w + 1) / workers;
+        pool.emplace_back([begin, end, &work] {
+            for (std::size_t i = begin; i < end; i++) work(i);
+        });
+    }
+    for (std::thread& thread : pool) thread.join();
+}
+
+bool buildYearGrids(int firstYear, int lastYear, YearGrid* out, unsigned threads) {
+    if (firstYear < 1 || lastYear > 5000 || lastYear < firstYear) return false;
+    forEachYear((std::size_t)(lastYear - firstYear + 1), threads,
+                [&](std::size_t i) { buildYearGrid(firstYear + (int)i, out[i]); });
+    return true;
+}
+
+bool writeYearGrids(int firstYear, int lastYear, FormatTemplate format, unsigned threads, std::FILE* out) {
+    if (firstYear < 1 || lastYear > 5000 || lastYear < firstYear) return false;
+
+    // Years are built and rendered a batch at a time, each into its own slot, then written in order
+    const std::size_t batchYears = 16 * (std::size_t)std::max(1u, threads);
+    std::unique_ptr<char[]> text(new char[batchYears * YEAR_GRID_TEXT_BYTES]);
+    std::vector<std::size_t> lengths(batchYears);
+
+    for (int batchFirst = firstYear; batchFirst <= lastYear; batchFirst += (int)batchYears) {
+        std::size_t count = std::min<std::size_t>(batchYears, (std::size_t)(lastYear - batchFirst + 1));
+        forEachYear(count, threads, [&](std::size_t i) {
+            YearGrid grid;
+            buildYearGrid(batchFirst + (int)i, grid);
+            lengths[i] = formatYearGrid(grid, format, text.get() + i * YEAR_GRID_TEXT_BYTES, YEAR_GRID_TEXT_BYTES);
+        });
+        for (std::size_t i = 0; i < count; i++) {
+            if (std::fwrite(text.get() + i * YEAR_GRID_TEXT_BYTES, 1, lengths[i], out) != lengths[i]) return false;
+        }
+    }
+    return std::fflush(out) == 0;
+}
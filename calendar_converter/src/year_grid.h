@@ -0,0 +1,50 @@
+// This file is for the year grid generator
+// it lays out a whole Ethiopian year in one flat struct (every day with its weekday, Gregorian
+// and Hijri dates, Ayyaana and moveable feast) for rendering wall calendars, and builds
+// many years in parallel
+
+#pragma once  // prevent multiple inclusions
+#include "calendar_core.h"
+#include "format.h"  // for FormatTemplate
+#include <cstdint>  // for fixed-width integer types
+#include <cstdio>   // for std::FILE
+
+const int GRID_MAX_DAYS = 366;
+const std::int8_t GRID_NO_FEAST = -1;
+
+// One day of the grid, 12 bytes; the Ethiopian date is implied by its position
+struct GridDay {
+    std::int16_t gregorianYear;
+    std::uint8_t gregorianMonth;
+    std::uint8_t gregorianDay;
+    std::int16_t islamicYear;
+    std::uint8_t islamicMonth;
+    std::uint8_t islamicDay;
+    std::uint8_t weekday;   // 0 = Sunday
+    std::uint8_t ayyaana;   // index into SIDAMA_AYYAANA
+    std::int8_t feast;      // MoveableFeast falling on this day, or GRID_NO_FEAST
+    std::uint8_t reserved;
+};
+
+// An Ethiopian year: Meskerem 1 .. Pagume 5 (6 in leap years)
+struct YearGrid {
+    int year;
+    long firstJdn;   // Meskerem 1
+    int dayCount;    // 365 or 366
+    BahereHasabValues bahereHasab;
+    MoveableFeasts feasts;
+    GridDay days[GRID_MAX_DAYS];
+};
+
+// Position of an Ethiopian month/day in YearGrid::days (every month but Pagume has 30 days)
+constexpr int gridIndex(int month, int day) { return 30 * (month - 1) + day - 1; }
+
+// Fill `grid` for one Ethiopian year (1-5000); returns false outside that range
+bool buildYearGrid(int year, YearGrid& grid);
+
+// Fill out[0 .. lastYear - firstYear] using up to `threads` threads; returns false if any year is out of range
+bool buildYearGrids(int firstYear, int lastYear, YearGrid* out, unsigned threads);
+
+// Build and render firstYear..lastYear (see formatYearGrid in format.h) to `out` in year order,
+// building and rendering in parallel. Returns false on a bad range or a write error.
+bool writeYearGrids(int firstYear, int lastYear, FormatTemplate format, unsigned threads, std::FILE* out);
@@ -0,0 +1,66 @@
+// This file is for the calendar_checks target (run by ctest)
+// it checks the engine's results against independent paths through it and exits with status 1
+// on the first mismatch, naming the check and the failing input on stderr
+//
+// usage: calendar_checks [CHECK]   (every check when none is named)
+
+#include "calendar_extended.h"  // convertJDNExtended, the reference for the checks below
+#include "year_grid.h"
+#include <cstdio>
+#include <cstring>  // for std::strcmp
+
+// Years whose grids are checked cell by cell against convertJDNExtended: the first, one before the
+// Hijri epoch (year 614 ends just after it), both sides of it, the present, the last
+static const int CHECKED_GRID_YEARS[] = {1, 100, 614, 615, 2016, 5000};
+
+static bool checkYearGrids() {
+    YearGrid grid;
+    for (int year : CHECKED_GRID_YEARS) {
+        buildYearGrid(year, grid);
+        for (int i = 0; i < grid.dayCount; i++) {
+            const GridDay& day = grid.days[i];
+            ConvertedDate expected = convertJDNExtended(grid.firstJdn + i);
+            const CalendarDate& eth = expected.ethiopian;
+            const CalendarDate& greg = expected.gregorian;
+            const CalendarDate& hijri = expected.islamic;
+            bool same = eth.year == year && gridIndex(eth.month, eth.day) == i;
+            same = same && greg.day == day.gregorianDay && greg.month == day.gregorianMonth &&
+                   greg.year == day.gregorianYear;
+            same = same && hijri.day == day.islamicDay && hijri.month == day.islamicMonth &&
+                   hijri.year == day.islamicYear;
+            same = same && expected.ayyaana == day.ayyaana && weekdayFromJDN(expected.jdn) == day.weekday;
+            if (!same) {
+                std::fprintf(stderr, "year_grids: year %d, day %d differs from convertJDNExtended\n", year, i);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+struct Check {
+    const char* name;
+    bool (*run)();
+};
+
+static const Check CHECKS[] = {
+    {"year_grids", checkYearGrids},
+};
+
+int main(int argc, char* argv[]) {
+    if (argc > 2) {
+        std::fprintf(stderr, "usage: calendar_checks [CHECK]\n");
+        return 2;
+    }
+    bool found = false;
+    for (const Check& check : CHECKS) {
+        if (argc == 2 && std::strcmp(argv[1], check.name) != 0) continue;
+        found = true;
+        if (!check.run()) return 1;
+    }
+    if (!found) {
+        std::fprintf(stderr, "calendar_checks: no check named %s\n", argv[1]);
+        return 2;
+    }
+    return 0;
+}
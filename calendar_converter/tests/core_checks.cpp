@@ -0,0 +1,58 @@
+// This file is part of the calendar_checks target
+// it holds the compile-time checks of the constexpr core and the extended range: known anchors and
+// leap rules, so building the checks fails as soon as one of them no longer holds
+
+#include "calendar_extended.h"  // includes calendar_core.h
+
+// The core (calendar_core.h)
+static_assert(gregorianToJDN(1, 1, 2000) == 2451545, "J2000.0 epoch");
+static_assert(gregorianToJDN(11, 9, 2024) == ethiopianToJDN(1, 1, 2017), "Enkutatash 2017 falls on 11 Sep 2024");
+static_assert(ethiopianToJDN(1, 1, 1) == ETHIOPIAN_EPOCH_JDN, "Meskerem 1, 1 is the Ethiopian epoch");
+static_assert(gregorianFromJDN(2460565).day == 11 && gregorianFromJDN(2460565).month == 9 &&
+              gregorianFromJDN(2460565).year == 2024, "JDN -> Gregorian");
+static_assert(ethiopianFromJDN(gregorianToJDN(11, 9, 2023)).month == 13 &&
+              ethiopianFromJDN(gregorianToJDN(11, 9, 2023)).day == 6, "Pagume 6, 2015 (leap year)");
+static_assert(ethiopianFromJDN(ethiopianToJDN(5, 13, 2016)).day == 5 &&
+              ethiopianFromJDN(ethiopianToJDN(5, 13, 2016) + 1).year == 2017, "Pagume 5 ends a common year");
+static_assert(islamicFromJDN(ISLAMIC_EPOCH_JDN).day == 1 && islamicFromJDN(ISLAMIC_EPOCH_JDN).month == 1 &&
+              islamicFromJDN(ISLAMIC_EPOCH_JDN).year == 1, "Hijri epoch");
+static_assert(islamicFromJDN(gregorianToJDN(7, 9, 2024)).day == 4 &&
+              islamicFromJDN(gregorianToJDN(7, 9, 2024)).month == 3 &&
+              islamicFromJDN(gregorianToJDN(7, 9, 2024)).year == 1446, "4 Rabi al-Awwal 1446");
+static_assert(islamicToJDN(4, 3, 1446) == gregorianToJDN(7, 9, 2024), "Hijri -> JDN");
+static_assert(weekdayFromJDN(gregorianToJDN(11, 9, 2024)) == 3, "Enkutatash 2017 is a Wednesday");
+static_assert(monthLength(2, 2000, GREGORIAN) == 29 && monthLength(2, 1900, GREGORIAN) == 28, "Gregorian leap rule");
+static_assert(monthLength(12, 2, ISLAMIC) == 30 && monthLength(12, 1, ISLAMIC) == 29, "Hijri leap rule");
+static_assert(!isValidCalendarDate(6, 13, 2016, ETHIOPIAN) && isValidCalendarDate(6, 13, 2015, ETHIOPIAN), "Pagume 6");
+
+// ... Julian, Coptic and any-to-any
+static_assert(julianToJDN(1, 1, 2000) == gregorianToJDN(14, 1, 2000), "Julian calendar is 13 days behind in 2000");
+static_assert(julianToJDN(25, 12, 2024) == ethiopianToJDN(29, 4, 2017), "Genna: Tahsas 29 is Julian Christmas");
+static_assert(julianFromJDN(gregorianToJDN(14, 3, 1900)).day == 1 &&
+              julianFromJDN(gregorianToJDN(14, 3, 1900)).month == 3, "Julian 29 February 1900 exists");
+static_assert(copticToJDN(1, 1, 1741) == ethiopianToJDN(1, 1, 2017), "Nayrouz 1741 AM is Enkutatash 2017");
+static_assert(copticFromJDN(COPTIC_EPOCH_JDN).year == 1 && copticFromJDN(COPTIC_EPOCH_JDN - 1).month == 13,
+              "Coptic epoch");
+static_assert(convertCalendarDate({4, 3, 1446}, ISLAMIC, ETHIOPIAN).day == 2 &&
+              convertCalendarDate({4, 3, 1446}, ISLAMIC, ETHIOPIAN).month == 13, "Hijri -> Ethiopian via any-to-any");
+static_assert(monthLength(2, 1900, JULIAN) == 29 && monthLength(13, 1739, COPTIC) == 6,
+              "Julian / Coptic month lengths");
+static_assert(isKnownCalendar(GREGORIAN) && isKnownCalendar(COPTIC) && !isKnownCalendar(CalendarType()) &&
+              !isKnownCalendar(static_cast<CalendarType>(COPTIC + 1)), "unknown calendars");
+
+// The extended range (calendar_extended.h)
+static_assert(floorDiv(-1, 4) == -1 && floorMod(-1, 4) == 3 && floorDiv(8, 4) == 2, "floor division");
+static_assert(WideCalendar<GregorianCalendar>::toJDN(24, 11, -4713) == 0 &&
+              WideCalendar<JulianCalendar>::toJDN(1, 1, -4712) == 0, "JDN 0 in both proleptic calendars");
+static_assert(WideCalendar<GregorianCalendar>::toJDN(1, 1, 2000) == gregorianToJDN(1, 1, 2000) &&
+              WideCalendar<IslamicCalendar>::toJDN(4, 3, 1446) == islamicToJDN(4, 3, 1446),
+              "wide and core arithmetic agree");
+static_assert(wideMonthLength<GregorianCalendar>(2, 0) == 29 && wideMonthLength<GregorianCalendar>(2, -100) == 28 &&
+              wideMonthLength<EthiopianCalendar>(13, -1) == 6, "leap rules for years <= 0");
+static_assert(extendedFromJDN<EthiopianCalendar>(ETHIOPIAN_EPOCH_JDN - 1).year == 0 &&
+              extendedFromJDN<EthiopianCalendar>(ETHIOPIAN_EPOCH_JDN - 1).month == 13,
+              "the day before the Ethiopian epoch");
+static_assert(extendedFromJDN<IslamicCalendar>(gregorianToJDN(1, 1, 500)).year == -126, "Hijri dates before the Hijra");
+static_assert(extendedFromJDN<GregorianCalendar>(-363521440).year == -1000000 &&
+              isValidExtendedDate(1, 1, -1000000, JULIAN) && !isValidExtendedDate(1, 1, 1000001, GREGORIAN),
+              "extended year range");